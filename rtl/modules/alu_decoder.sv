@@ -7,11 +7,18 @@ module alu_decoder (
     input  logic [1:0] ALUOp_type_i,   // From main_decoder
     input  logic [2:0] funct3_i,
     input  logic       funct7_5_i,       // Corresponds to instr[30]
+    input  logic       funct7_0_i,       // Corresponds to instr[25]: M extension in OP/OP-32
 
     output logic [2:0] ALUControl_o,   // To ALU module
-    output logic       ALUModifier_o   // To ALU module (for SLT vs SLTU, SRA vs SRL)
+    output logic       ALUModifier_o,  // To ALU module (for SLT vs SLTU, SRA vs SRL)
+    output logic       MulDiv_o,       // Multiplier/divider instead of the ALU
+    output logic [3:0] MulDivOp_o      // {W variant, funct3}
 );
 
+    // instr[25] is also bit 5 of a 64-bit shift amount, so only OP/OP-32 count
+    assign MulDiv_o = (op_i == `OPCODE_R_ALU || op_i == `OPCODE_R_ALU_W) && funct7_0_i;
+    assign MulDivOp_o = {op_i == `OPCODE_R_ALU_W, funct3_i};
+
     always_comb begin
         ALUControl_o  = `ALU_OP_ADD;       // Default operation
         ALUModifier_o = `ALU_SELECT_SIGNED; // Default modifier (signed for SLT, logical for SR)
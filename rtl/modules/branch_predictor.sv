@@ -0,0 +1,135 @@
+`include "common/defines.svh"
+
+// Fetch-stage branch predictor: a direct-mapped BTB, a table of 2-bit
+// saturating counters (bimodal, or gshare when GSHARE = 1) and a return
+// address stack. Fetch gets a prediction for pc_f_i in the same cycle;
+// Execute trains the tables when a branch or jump resolves.
+//
+// Global history and the RAS are updated at resolution rather than
+// speculatively at prediction, so a misprediction needs no repair here; the
+// pipeline checks every prediction in Execute and redirects Fetch on a miss.
+module branch_predictor #(
+    parameter GSHARE   = 0,  // BHT index: 0 = PC, 1 = PC xor global history
+    parameter BHT_BITS = 9,  // log2 of BHT entries, >= 2
+    parameter BTB_BITS = 6,  // log2 of BTB entries
+    parameter RAS_BITS = 2   // log2 of RAS depth
+) (
+    input  logic clk_i,
+    input  logic rst_i,
+
+    // Fetch
+    input  logic [`DATA_WIDTH-1:0] pc_f_i,
+    output logic                   taken_f_o,
+    output logic [`DATA_WIDTH-1:0] target_f_o,
+
+    // Execute: the instruction in E is a branch or jump
+    input  logic                   update_e_i,
+    input  logic                   branch_e_i,  // conditional branch, otherwise jump
+    input  logic                   call_e_i,    // JAL/JALR with rd = x1/x5
+    input  logic                   return_e_i,  // JALR with rs1 = x1/x5, not a call
+    input  logic                   taken_e_i,
+    input  logic [`DATA_WIDTH-1:0] pc_e_i,
+    input  logic [`DATA_WIDTH-1:0] pc_4_e_i,
+    input  logic [`DATA_WIDTH-1:0] target_e_i
+);
+
+    localparam BTB_ENTRIES = 1 << BTB_BITS;
+    localparam BHT_ENTRIES = 1 << BHT_BITS;
+    localparam RAS_DEPTH   = 1 << RAS_BITS;
+    localparam TAG_WIDTH   = `DATA_WIDTH - BTB_BITS - 2;
+
+    localparam logic [1:0] KIND_BRANCH = 2'd0;
+    localparam logic [1:0] KIND_JUMP   = 2'd1;
+    localparam logic [1:0] KIND_CALL   = 2'd2;
+    localparam logic [1:0] KIND_RETURN = 2'd3;
+
+    logic                   btb_valid  [BTB_ENTRIES];
+    logic [TAG_WIDTH-1:0]   btb_tag    [BTB_ENTRIES];
+    logic [`DATA_WIDTH-1:0] btb_target [BTB_ENTRIES];
+    logic [1:0]             btb_kind   [BTB_ENTRIES];
+
+    logic [1:0]             bht [BHT_ENTRIES];
+    logic [BHT_BITS-1:0]    ghr;
+
+    logic [`DATA_WIDTH-1:0] ras [RAS_DEPTH];
+    logic [RAS_BITS-1:0]    ras_top;
+    logic [RAS_BITS:0]      ras_count;
+
+    // Prediction
+
+    logic [BTB_BITS-1:0] btb_index_f;
+    logic [BHT_BITS-1:0] bht_index_f;
+    logic                btb_hit_f;
+
+    assign btb_index_f = pc_f_i[BTB_BITS+1:2];
+    assign bht_index_f = GSHARE ? (pc_f_i[BHT_BITS+1:2] ^ ghr) : pc_f_i[BHT_BITS+1:2];
+    assign btb_hit_f = btb_valid[btb_index_f] && (btb_tag[btb_index_f] == pc_f_i[`DATA_WIDTH-1:BTB_BITS+2]);
+
+    always_comb begin
+        taken_f_o = 1'b0;
+        target_f_o = btb_target[btb_index_f];
+        if (btb_hit_f) begin
+            case (btb_kind[btb_index_f])
+                KIND_BRANCH: taken_f_o = bht[bht_index_f][1];
+                KIND_RETURN: begin
+                    taken_f_o = 1'b1;
+                    if (ras_count != '0)
+                        target_f_o = ras[ras_top];
+                end
+                default:     taken_f_o = 1'b1;
+            endcase
+        end
+    end
+
+    // Training
+
+    logic [BTB_BITS-1:0] btb_index_e;
+    logic [BHT_BITS-1:0] bht_index_e;
+    logic [1:0]          kind_e;
+
+    assign btb_index_e = pc_e_i[BTB_BITS+1:2];
+    assign bht_index_e = GSHARE ? (pc_e_i[BHT_BITS+1:2] ^ ghr) : pc_e_i[BHT_BITS+1:2];
+    assign kind_e = branch_e_i ? KIND_BRANCH :
+                    call_e_i   ? KIND_CALL   :
+                    return_e_i ? KIND_RETURN : KIND_JUMP;
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            for (int i = 0; i < BTB_ENTRIES; i++)
+                btb_valid[i] <= 1'b0;
+            for (int i = 0; i < BHT_ENTRIES; i++)
+                bht[i] <= 2'b01;  // weakly not taken
+            ghr <= '0;
+            ras_top <= '0;
+            ras_count <= '0;
+        end else if (update_e_i) begin
+            if (branch_e_i) begin
+                if (taken_e_i && bht[bht_index_e] != 2'b11)
+                    bht[bht_index_e] <= bht[bht_index_e] + 2'b01;
+                else if (!taken_e_i && bht[bht_index_e] != 2'b00)
+                    bht[bht_index_e] <= bht[bht_index_e] - 2'b01;
+                ghr <= {ghr[BHT_BITS-2:0], taken_e_i};
+            end
+
+            // Not-taken branches stay out of the BTB: a miss predicts fall-through
+            if (taken_e_i) begin
+                btb_valid[btb_index_e] <= 1'b1;
+                btb_tag[btb_index_e] <= pc_e_i[`DATA_WIDTH-1:BTB_BITS+2];
+                btb_target[btb_index_e] <= target_e_i;
+                btb_kind[btb_index_e] <= kind_e;
+            end
+
+            // Circular stack: a push past the depth overwrites the oldest entry
+            if (call_e_i) begin
+                ras[ras_top + RAS_BITS'(1)] <= pc_4_e_i;
+                ras_top <= ras_top + RAS_BITS'(1);
+                if (ras_count != (RAS_BITS+1)'(RAS_DEPTH))
+                    ras_count <= ras_count + 1'b1;
+            end else if (return_e_i && ras_count != '0) begin
+                ras_top <= ras_top - RAS_BITS'(1);
+                ras_count <= ras_count - 1'b1;
+            end
+        end
+    end
+
+endmodule
@@ -0,0 +1,31 @@
+`include "common/defines.svh"
+
+// Condition of a conditional branch (funct3 of BEQ/BNE/BLT/BGE/BLTU/BGEU).
+// Shared by the Execute-stage resolution and the optional Decode-stage one.
+module branch_unit (
+    input  logic [2:0]             funct3_i,
+    input  logic [`DATA_WIDTH-1:0] a_i,
+    input  logic [`DATA_WIDTH-1:0] b_i,
+    output logic                   taken_o
+);
+
+    logic equal;
+    logic less;
+    logic less_unsigned;
+    assign equal = (a_i == b_i);
+    assign less = ($signed(a_i) < $signed(b_i));
+    assign less_unsigned = (a_i < b_i);
+
+    always_comb begin
+        case (funct3_i)
+            3'b000:  taken_o = equal;           // BEQ
+            3'b001:  taken_o = !equal;          // BNE
+            3'b100:  taken_o = less;            // BLT
+            3'b101:  taken_o = !less;           // BGE
+            3'b110:  taken_o = less_unsigned;   // BLTU
+            3'b111:  taken_o = !less_unsigned;  // BGEU
+            default: taken_o = 1'b0;
+        endcase
+    end
+
+endmodule
@@ -0,0 +1,157 @@
+`include "common/defines.svh"
+
+// Set-associative cache in front of a ram instance. Only tags and
+// replacement state are kept here: the data itself is always read from and
+// written to the backing ram, which stays the single copy of memory. Stores
+// are write-through with no allocation on a miss (a write buffer absorbs
+// them), so backing memory is never stale. The ram backdoor used by the
+// harness (ELF loading, state injection, checkpoints) keeps working
+// unchanged, and the cache only decides how many cycles an access takes.
+//
+// A read miss holds stall_o for MISS_LATENCY cycles, then installs the line;
+// the access hits on the following cycle. If the address moves to another
+// line while waiting (a redirect in Fetch), the fill starts over for the new line.
+module cache #(
+    parameter SET_BITS     = 6,   // log2 of sets
+    parameter WAYS         = 2,
+    parameter LINE_BITS    = 5,   // log2 of line size in bytes
+    parameter REPLACEMENT  = 0,   // 0: LRU, 1: pseudo-random (LFSR)
+    parameter MISS_LATENCY = 10,  // backing memory latency in cycles, >= 1
+    parameter ADR_WIDTH    = `DATA_WIDTH
+) (
+    input  logic                 clk_i,
+    input  logic                 rst_i,
+
+    input  logic                 req_i,   // access in this cycle
+    input  logic                 we_i,    // store: never stalls
+    input  logic                 hold_i,  // the pipeline repeats this access next cycle
+    input  logic [ADR_WIDTH-1:0] adr_i,
+    output logic                 stall_o,
+
+    // One-cycle event pulses for perf_counters
+    output logic                 hit_o,
+    output logic                 miss_o,
+    output logic                 evict_o
+);
+
+    localparam SETS      = 1 << SET_BITS;
+    localparam WAY_BITS  = (WAYS > 1) ? $clog2(WAYS) : 1;
+    localparam LINE_ADR  = ADR_WIDTH - LINE_BITS;
+    localparam TAG_WIDTH = LINE_ADR - SET_BITS;
+    localparam LAT_BITS  = $clog2(MISS_LATENCY + 1);
+
+    // Way w of set s lives at index s * WAYS + w
+    logic                 valid [SETS * WAYS];
+    logic [TAG_WIDTH-1:0] tags  [SETS * WAYS];
+    logic [WAY_BITS-1:0]  age   [SETS * WAYS];  // LRU: 0 = most recently used
+
+    logic [LINE_ADR-1:0]  line;
+    logic [SET_BITS-1:0]  set;
+    logic [TAG_WIDTH-1:0] tag;
+
+    assign line = adr_i[ADR_WIDTH-1:LINE_BITS];
+    assign set = line[SET_BITS-1:0];
+    assign tag = line[LINE_ADR-1:SET_BITS];
+
+    // Lookup
+
+    logic                hit;
+    logic [WAY_BITS-1:0] hit_way;
+
+    always_comb begin
+        hit = 1'b0;
+        hit_way = '0;
+        for (int w = 0; w < WAYS; w++) begin
+            if (valid[int'(set) * WAYS + w] && tags[int'(set) * WAYS + w] == tag) begin
+                hit = 1'b1;
+                hit_way = WAY_BITS'(w);
+            end
+        end
+    end
+
+    // Victim: an invalid way if there is one, else LRU or random
+
+    logic [15:0]         lfsr;
+    logic [WAY_BITS-1:0] victim;
+
+    always_comb begin
+        victim = (REPLACEMENT == 1) ? WAY_BITS'(lfsr % 16'(WAYS)) : '0;
+        if (REPLACEMENT != 1) begin
+            for (int w = 0; w < WAYS; w++) begin
+                if (age[int'(set) * WAYS + w] == WAY_BITS'(WAYS - 1))
+                    victim = WAY_BITS'(w);
+            end
+        end
+        for (int w = WAYS - 1; w >= 0; w--) begin
+            if (!valid[int'(set) * WAYS + w])
+                victim = WAY_BITS'(w);
+        end
+    end
+
+    // Miss handling
+
+    logic                read_miss;
+    logic                filling;      // fill_line is being fetched
+    logic [LINE_ADR-1:0] fill_line;
+    logic [LAT_BITS-1:0] fill_cycles;  // cycles already spent on fill_line
+    logic [LAT_BITS-1:0] spent;
+    logic                install;
+    logic                just_filled;  // the next hit on fill_line completes a miss
+
+    assign read_miss = req_i && !we_i && !hit;
+    assign spent = (filling && fill_line == line) ? fill_cycles : '0;
+    assign install = read_miss && (spent == LAT_BITS'(MISS_LATENCY - 1));
+    assign stall_o = read_miss;
+
+    assign miss_o = req_i && !hit && (we_i ? !hold_i : spent == '0);
+    assign hit_o = req_i && hit && !hold_i && !(just_filled && fill_line == line);
+    assign evict_o = install && valid[int'(set) * WAYS + int'(victim)];
+
+    // The line used by this cycle's access becomes the most recently used
+    logic                touch;
+    logic [WAY_BITS-1:0] touch_way;
+
+    assign touch = install || (req_i && hit && !hold_i);
+    assign touch_way = install ? victim : hit_way;
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            for (int i = 0; i < SETS * WAYS; i++) begin
+                valid[i] <= 1'b0;
+                age[i] <= WAY_BITS'(i % WAYS);
+            end
+            filling <= 1'b0;
+            fill_cycles <= '0;
+            just_filled <= 1'b0;
+            lfsr <= 16'hACE1;
+        end else begin
+            lfsr <= {lfsr[14:0], lfsr[15] ^ lfsr[13] ^ lfsr[12] ^ lfsr[10]};
+
+            if (install) begin
+                valid[int'(set) * WAYS + int'(victim)] <= 1'b1;
+                tags[int'(set) * WAYS + int'(victim)] <= tag;
+                filling <= 1'b0;
+                fill_line <= line;
+                just_filled <= 1'b1;
+            end else if (read_miss) begin
+                filling <= 1'b1;
+                fill_line <= line;
+                fill_cycles <= spent + 1'b1;
+            end else begin
+                filling <= 1'b0;
+                if (req_i && hit && !hold_i)
+                    just_filled <= 1'b0;
+            end
+
+            // Ways younger than the touched one age by one
+            if (touch) begin
+                for (int w = 0; w < WAYS; w++) begin
+                    if (age[int'(set) * WAYS + w] < age[int'(set) * WAYS + int'(touch_way)])
+                        age[int'(set) * WAYS + w] <= age[int'(set) * WAYS + w] + 1'b1;
+                end
+                age[int'(set) * WAYS + int'(touch_way)] <= '0;
+            end
+        end
+    end
+
+endmodule
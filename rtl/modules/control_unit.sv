@@ -1,10 +1,12 @@
 `include "common/defines.svh"
+`include "common/opcodes.svh"
 
 module control_unit (
     // Inputs from instruction word (ID stage)
     input  logic [6:0] op_i,         // Opcode instr[6:0]
     input  logic [2:0] funct3_i,     // instr[14:12]
     input  logic       funct7_5_i,   // instr[30]
+    input  logic       funct7_0_i,   // instr[25]
 
     // Control Signals for ID/EX pipeline register (and other units in ID)
     output logic       RegWriteD_o,
@@ -16,16 +18,20 @@ module control_unit (
     output logic [1:0] ImmSelD_o,    // To select immediate type for imm_gen
     output logic       Is_U_typeD_o, // To indicate LUI/AUIPC for special imm handling
     output logic [2:0] ALUControlD_o,
-    output logic       ALUModifierD_o
+    output logic       ALUModifierD_o,
+    output logic       MulDivD_o,    // M extension: multiplier/divider result
+    output logic [3:0] MulDivOpD_o   // {W variant, funct3}
 );
 
     logic [1:0] alu_op_type_w; // Wire between main_decoder and alu_decoder
+    logic       reg_write_w;
+    logic [1:0] result_src_w;
 
     main_decoder main_dec_inst (
         .op_i(op_i),
 
-        .RegWrite_o(RegWriteD_o),
-        .ResultSrc_o(ResultSrcD_o),
+        .RegWrite_o(reg_write_w),
+        .ResultSrc_o(result_src_w),
         .MemWrite_o(MemWriteD_o),
         .Jump_o(JumpD_o),
         .Branch_o(BranchD_o),
@@ -40,9 +46,17 @@ module control_unit (
         .ALUOp_type_i(alu_op_type_w),
         .funct3_i(funct3_i),
         .funct7_5_i(funct7_5_i),
+        .funct7_0_i(funct7_0_i),
 
         .ALUControl_o(ALUControlD_o),
-        .ALUModifier_o(ALUModifierD_o)
+        .ALUModifier_o(ALUModifierD_o),
+        .MulDiv_o(MulDivD_o),
+        .MulDivOp_o(MulDivOpD_o)
     );
 
+    // OP-32 is decoded for the M extension only. Products come from the
+    // multiplier in Memory; quotients and remainders take the ALU's path.
+    assign RegWriteD_o = reg_write_w || MulDivD_o;
+    assign ResultSrcD_o = (MulDivD_o && !MulDivOpD_o[2]) ? `RESSRC_MUL : result_src_w;
+
 endmodule
\ No newline at end of file
@@ -0,0 +1,119 @@
+`include "common/defines.svh"
+`include "common/alu_defines.svh"
+
+// Iterative radix-2 divider for DIV, DIVU, REM, REMU and their W variants.
+// The instruction stays in Execute while busy_o is high: one cycle to latch
+// the operand magnitudes, one cycle per quotient bit, then the result is on
+// result_o until Execute moves on. Division by zero skips the iterations.
+// Signs and the W variants are handled around an unsigned 64-bit divide, so
+// division by zero and MIN / -1 give the results the ISA specifies.
+module divider (
+    input  logic                   clk_i,
+    input  logic                   rst_i,
+
+    input  logic                   start_i,    // a division is in Execute
+    input  logic                   hold_i,     // Execute cannot move on this cycle
+    input  logic [3:0]             op_i,       // {W variant, funct3}
+    input  logic [`DATA_WIDTH-1:0] a_i,
+    input  logic [`DATA_WIDTH-1:0] b_i,
+
+    output logic                   busy_o,
+    output logic [`DATA_WIDTH-1:0] result_o
+);
+
+    localparam COUNT_BITS = $clog2(`DATA_WIDTH + 1);
+
+    typedef enum logic [1:0] {
+        IDLE,
+        BUSY,
+        DONE
+    } state_t;
+
+    state_t state;
+
+    logic is_signed;
+    logic is_word;
+    assign is_signed = !op_i[0];
+    assign is_word = op_i[3];
+
+    // W variants divide the sign- or zero-extended low words
+    logic [`DATA_WIDTH-1:0] a_op;
+    logic [`DATA_WIDTH-1:0] b_op;
+    assign a_op = is_word ? {{(`DATA_WIDTH-32){is_signed && a_i[31]}}, a_i[31:0]} : a_i;
+    assign b_op = is_word ? {{(`DATA_WIDTH-32){is_signed && b_i[31]}}, b_i[31:0]} : b_i;
+
+    logic a_neg;
+    logic b_neg;
+    assign a_neg = is_signed && a_op[`DATA_WIDTH-1];
+    assign b_neg = is_signed && b_op[`DATA_WIDTH-1];
+
+    logic [`DATA_WIDTH-1:0]   quotient;   // shifts the dividend out as quotient bits come in
+    logic [`DATA_WIDTH-1:0]   remainder;
+    logic [`DATA_WIDTH-1:0]   divisor;
+    logic [`DATA_WIDTH-1:0]   dividend;   // for REM by zero
+    logic [COUNT_BITS-1:0]    count;
+    logic                     by_zero;
+    logic                     quotient_neg;
+    logic                     remainder_neg;
+    logic                     want_remainder;
+    logic                     word;
+
+    // One restoring step: bring down the next dividend bit, subtract if it fits
+    logic [`DATA_WIDTH:0] partial;
+    logic [`DATA_WIDTH:0] difference;
+    assign partial = {remainder, quotient[`DATA_WIDTH-1]};
+    assign difference = partial - {1'b0, divisor};
+
+    assign busy_o = (state == IDLE && start_i) || state == BUSY;
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            state <= IDLE;
+        end else begin
+            case (state)
+                IDLE: if (start_i) begin
+                    quotient <= a_neg ? -a_op : a_op;
+                    remainder <= '0;
+                    divisor <= b_neg ? -b_op : b_op;
+                    dividend <= a_op;
+                    count <= COUNT_BITS'(`DATA_WIDTH);
+                    by_zero <= (b_op == '0);
+                    quotient_neg <= a_neg ^ b_neg;
+                    remainder_neg <= a_neg;
+                    want_remainder <= op_i[1];
+                    word <= is_word;
+                    state <= (b_op == '0) ? DONE : BUSY;
+                end
+                BUSY: begin
+                    if (difference[`DATA_WIDTH]) begin
+                        remainder <= partial[`DATA_WIDTH-1:0];
+                        quotient <= {quotient[`DATA_WIDTH-2:0], 1'b0};
+                    end else begin
+                        remainder <= difference[`DATA_WIDTH-1:0];
+                        quotient <= {quotient[`DATA_WIDTH-2:0], 1'b1};
+                    end
+                    count <= count - 1'b1;
+                    if (count == 1)
+                        state <= DONE;
+                end
+                DONE: if (!hold_i)
+                    state <= IDLE;
+                default: state <= IDLE;
+            endcase
+        end
+    end
+
+    logic [`DATA_WIDTH-1:0] result;
+
+    always_comb begin
+        if (by_zero)
+            result = want_remainder ? dividend : '1;
+        else if (want_remainder)
+            result = remainder_neg ? -remainder : remainder;
+        else
+            result = quotient_neg ? -quotient : quotient;
+    end
+
+    assign result_o = word ? {{(`DATA_WIDTH-32){result[31]}}, result[31:0]} : result;
+
+endmodule
@@ -0,0 +1,68 @@
+`include "common/defines.svh"
+`include "common/opcodes.svh"
+
+// Macro-op fusion (MACRO_FUSION = 1): pairs of adjacent instructions that
+// compilers emit together and that run as one internal op in one slot:
+//   lui   rd, hi;       addi rd, rd, lo      -> rd = hi + lo
+//   auipc rd, hi;       jalr rd, lo(rd)      -> jump to pc + hi + lo, rd = pc + 8
+//   slt[u] rd, a, b;    bne/beq rd, x0, off  -> rd = a < b, branch on a < b
+// In each pair the second instruction either overwrites the first one's rd
+// or writes nothing, so a single register write retires both.
+// RV64 compilers materialize 32-bit constants as lui + addiw, not lui + addi;
+// the core has no OP-IMM-32 (addiw and friends), so that pair is neither
+// executed nor fused, and speedups measured here on hand-written lui + addi
+// code do not carry over to typical RV64 compiler output.
+// Fetch uses fuse_o to take the pair as one instruction; Decode, which
+// carries the second word in if_id, uses the rest to build the fused op on
+// top of the first instruction's control_unit decode.
+module fusion (
+    input  logic [`INSTR_WIDTH-1:0] instr_i,       // instruction at pc
+    input  logic [`INSTR_WIDTH-1:0] next_i,        // instruction at pc + 4
+
+    output logic                    fuse_o,
+    output logic                    jump_o,         // auipc + jalr: a jump linking pc + 8
+    output logic                    branch_o,       // slt + bne/beq: also a branch
+    output logic [2:0]              branch_funct3_o,
+    output logic [`DATA_WIDTH-1:0]  imm_o           // the fused op's immediate, relative to pc
+);
+
+    logic [6:0] op1;
+    logic [6:0] op2;
+    logic [`REG_ADDR_WIDTH-1:0] rd1;
+    assign op1 = instr_i[6:0];
+    assign op2 = next_i[6:0];
+    assign rd1 = instr_i[11:7];
+
+    // The second instruction reads and (except a branch) writes the first one's rd
+    logic chained;
+    assign chained = (rd1 != '0) && (next_i[19:15] == rd1);
+
+    logic lui_addi;
+    logic auipc_jalr;
+    logic slt_branch;
+    assign lui_addi = (op1 == `OPCODE_LUI) && (op2 == `OPCODE_I_ALU) && (next_i[14:12] == 3'b000) &&
+                      chained && (next_i[11:7] == rd1);
+    assign auipc_jalr = (op1 == `OPCODE_AUIPC) && (op2 == `OPCODE_JALR) && chained && (next_i[11:7] == rd1);
+    // slt/sltu (funct3 010/011, funct7 0) and beq/bne (funct3 000/001) against x0
+    assign slt_branch = (op1 == `OPCODE_R_ALU) && (instr_i[31:25] == 7'b0) && (instr_i[14:13] == 2'b01) &&
+                        (op2 == `OPCODE_BRANCH) && (next_i[14:13] == 2'b00) && chained &&
+                        (next_i[24:20] == '0);
+
+    assign fuse_o = lui_addi || auipc_jalr || slt_branch;
+    assign jump_o = auipc_jalr;
+    assign branch_o = slt_branch;
+
+    // bne taken when rd = 1: BLT/BLTU on the compared operands, beq: BGE/BGEU
+    assign branch_funct3_o = {1'b1, instr_i[12], !next_i[12]};
+
+    logic [`DATA_WIDTH-1:0] imm_u;
+    logic [`DATA_WIDTH-1:0] imm_i2;
+    logic [`DATA_WIDTH-1:0] imm_b2;
+    assign imm_u = {{(`DATA_WIDTH-32){instr_i[31]}}, instr_i[31:12], 12'b0};
+    assign imm_i2 = {{(`DATA_WIDTH-12){next_i[31]}}, next_i[31:20]};
+    assign imm_b2 = {{(`DATA_WIDTH-12){next_i[31]}}, next_i[7], next_i[30:25], next_i[11:8], 1'b0};
+
+    // The branch offset is relative to the second instruction
+    assign imm_o = slt_branch ? imm_b2 + `DATA_WIDTH'd4 : imm_u + imm_i2;
+
+endmodule
@@ -1,6 +1,9 @@
 `include "common/defines.svh"
 `include "common/opcodes.svh"
 
+// Signals ending in 2 belong to the second issue slot of a DUAL_ISSUE pipeline
+// (an integer ALU instruction, younger than the one in the first slot of the
+// same stage); a single-issue pipeline ties them to zero.
 module hazard_unit (
     input logic [4:0] Rs1E,
     input logic [4:0] Rs2E,
@@ -10,45 +13,116 @@ module hazard_unit (
     input logic [4:0] RdM,
     input logic [4:0] RdW,
 
+    input logic RegWriteE,
     input logic RegWriteM,
     input logic RegWriteW,
 
+    input logic [4:0] Rs1E2,
+    input logic [4:0] Rs2E2,
+    input logic [4:0] Rs1D2,
+    input logic [4:0] Rs2D2,
+    input logic [4:0] RdE2,
+    input logic [4:0] RdM2,
+    input logic [4:0] RdW2,
+
+    input logic RegWriteE2,
+    input logic RegWriteM2,
+    input logic RegWriteW2,
+
     input logic ResultSrcE0,
+    input logic ResultSrcM0,
+    input logic BranchD,   // EARLY_BRANCH: a branch or JALR in Decode reads its operands
+    input logic PCSrcD,    // EARLY_BRANCH: redirect from Decode
     input logic PCSrcE,
+    input logic IStallF,   // instruction cache miss in Fetch
+    input logic DStallM,   // data cache read miss in Memory
+    input logic DivStallE, // iterative divider busy in Execute
 
+    // Forwarding source stage (2'b10 Memory, 2'b01 Writeback) and, in the
+    // Slot outputs, whether it is that stage's second slot
     output logic [1:0] ForwardAE,
     output logic [1:0] ForwardBE,
+    output logic [1:0] ForwardAE2,
+    output logic [1:0] ForwardBE2,
+    output logic ForwardSlotAE,
+    output logic ForwardSlotBE,
+    output logic ForwardSlotAE2,
+    output logic ForwardSlotBE2,
+    output logic ForwardAD,  // Memory's ALU result to the Decode comparator
+    output logic ForwardBD,
 
     output logic StallF,
     output logic StallD,
+    output logic StallE,
+    output logic StallM,
+    output logic StallW,
     output logic FlushD,
-    output logic FlushE
+    output logic FlushE,
+    output logic FlushM,
+
+    // Causes of StallD, for perf_counters
+    output logic LoadUseStallD,
+    output logic BranchStallD
 );
 
     logic lwStall;
+    logic branchStall;
+
+    // {slot, stage} of the youngest in-flight write to Rs: Memory before
+    // Writeback, and within a stage the second slot before the first
+    function automatic logic [2:0] forward_source(input logic [4:0] Rs);
+        if (Rs == 0)
+            return 3'b000;
+        if ((Rs == RdM2) & RegWriteM2)
+            return 3'b110;
+        if ((Rs == RdM) & RegWriteM)
+            return 3'b010;
+        if ((Rs == RdW2) & RegWriteW2)
+            return 3'b101;
+        if ((Rs == RdW) & RegWriteW)
+            return 3'b001;
+        return 3'b000;
+    endfunction
 
     always_comb begin
-        if (((Rs1E == RdM) & RegWriteM) & (Rs1E != 0))
-            ForwardAE = 2'b10;
-        else if (((Rs1E == RdW) & RegWriteW) & (Rs1E != 0))
-            ForwardAE = 2'b01;
-        else
-            ForwardAE = 2'b00;
-
-        if (((Rs2E == RdM) & RegWriteM) & (Rs2E != 0))
-            ForwardBE = 2'b10;
-        else if (((Rs2E == RdW) & RegWriteW) & (Rs2E != 0))
-            ForwardBE = 2'b01;
-        else
-            ForwardBE = 2'b00;
-
-
-        lwStall = ResultSrcE0 & ((Rs1D == RdE) | (Rs2D == RdE));
-        StallF  = lwStall;
-        StallD  = lwStall;
-
-        FlushD = PCSrcE;
-        FlushE = lwStall | PCSrcE;
+        {ForwardSlotAE, ForwardAE} = forward_source(Rs1E);
+        {ForwardSlotBE, ForwardBE} = forward_source(Rs2E);
+        {ForwardSlotAE2, ForwardAE2} = forward_source(Rs1E2);
+        {ForwardSlotBE2, ForwardBE2} = forward_source(Rs2E2);
+
+
+        ForwardAD = (Rs1D != 0) & (Rs1D == RdM) & RegWriteM;
+        ForwardBD = (Rs2D != 0) & (Rs2D == RdM) & RegWriteM;
+
+        // Loads and multiplications (RESSRC_MEM, RESSRC_MUL) finish in Memory;
+        // they only issue in the first slot, and either slot of Decode may wait
+        lwStall = ResultSrcE0 & ((Rs1D == RdE) | (Rs2D == RdE) |
+                                 ((RdE != 0) & ((Rs1D2 == RdE) | (Rs2D2 == RdE))));
+
+        // A branch resolved in Decode waits for a source still in Execute,
+        // or for a load or a product in Memory. Its comparator is only wired
+        // to Memory's first slot, so a source in the second one waits as well.
+        branchStall = BranchD &
+                      ((RegWriteE & (RdE != 0) & ((Rs1D == RdE) | (Rs2D == RdE))) |
+                       (RegWriteE2 & (RdE2 != 0) & ((Rs1D == RdE2) | (Rs2D == RdE2))) |
+                       (RegWriteM2 & (RdM2 != 0) & ((Rs1D == RdM2) | (Rs2D == RdM2))) |
+                       (ResultSrcM0 & (ForwardAD | ForwardBD)));
+
+        // A data cache miss freezes every stage; an instruction cache miss
+        // holds Fetch and lets a bubble into Decode; a division holds Execute
+        // and everything before it while Memory and Writeback drain
+        StallF  = lwStall | branchStall | IStallF | DStallM | DivStallE;
+        StallD  = lwStall | branchStall | DStallM | DivStallE;
+        StallE  = DStallM | DivStallE;
+        StallM  = DStallM;
+        StallW  = DStallM;
+
+        FlushD = (PCSrcE | PCSrcD | (IStallF & ~lwStall & ~branchStall)) & ~StallE;
+        FlushE = (lwStall | branchStall | PCSrcE) & ~StallE;
+        FlushM = DivStallE & ~DStallM;
+
+        LoadUseStallD = lwStall;
+        BranchStallD = branchStall;
     end
 
 endmodule
\ No newline at end of file
@@ -0,0 +1,63 @@
+`include "common/defines.svh"
+`include "common/alu_defines.svh"
+
+// Two-stage pipelined multiplier for MUL, MULH, MULHSU, MULHU and MULW.
+// Execute forms two partial products of the 65-bit (sign- or zero-extended)
+// operands, a * b[31:0] and a * b[64:32]; Memory adds them into the full
+// 130-bit product and selects the result. A new multiplication can enter every
+// cycle, and a dependent instruction waits one cycle as it would after a load.
+module multiplier (
+    input  logic                   clk_i,
+    input  logic                   en_i,       // Execute moves into Memory
+
+    // Execute
+    input  logic [3:0]             op_i,       // {W variant, funct3}
+    input  logic [`DATA_WIDTH-1:0] a_i,
+    input  logic [`DATA_WIDTH-1:0] b_i,
+
+    // Memory: the product of the instruction now in Memory
+    output logic [`DATA_WIDTH-1:0] result_o
+);
+
+    logic a_signed;
+    logic b_signed;
+    assign a_signed = (op_i[2:0] == `MULDIV_MULH) || (op_i[2:0] == `MULDIV_MULHSU);
+    assign b_signed = (op_i[2:0] == `MULDIV_MULH);
+
+    logic signed [`DATA_WIDTH:0] a_ext;
+    logic signed [`DATA_WIDTH:0] b_ext;
+    assign a_ext = {a_signed && a_i[`DATA_WIDTH-1], a_i};
+    assign b_ext = {b_signed && b_i[`DATA_WIDTH-1], b_i};
+
+    localparam PP_WIDTH = `DATA_WIDTH + 34;
+
+    logic signed [PP_WIDTH-1:0] pp_lo_e;
+    logic signed [PP_WIDTH-1:0] pp_hi_e;
+    assign pp_lo_e = a_ext * $signed({1'b0, b_ext[31:0]});
+    assign pp_hi_e = a_ext * $signed(b_ext[`DATA_WIDTH:32]);
+
+    logic [PP_WIDTH-1:0] pp_lo_m;
+    logic [PP_WIDTH-1:0] pp_hi_m;
+    logic [3:0]          op_m;
+
+    always_ff @(posedge clk_i) begin
+        if (en_i) begin
+            pp_lo_m <= pp_lo_e;
+            pp_hi_m <= pp_hi_e;
+            op_m <= op_i;
+        end
+    end
+
+    logic [2*`DATA_WIDTH+1:0] product_m;
+    assign product_m = {{32{pp_lo_m[PP_WIDTH-1]}}, pp_lo_m} + {pp_hi_m, 32'b0};
+
+    always_comb begin
+        if (op_m[2:0] != `MULDIV_MUL)
+            result_o = product_m[2*`DATA_WIDTH-1:`DATA_WIDTH];
+        else if (op_m[3])
+            result_o = {{(`DATA_WIDTH-32){product_m[31]}}, product_m[31:0]};
+        else
+            result_o = product_m[`DATA_WIDTH-1:0];
+    end
+
+endmodule
@@ -0,0 +1,93 @@
+`include "common/defines.svh"
+`include "common/perf_defines.svh"
+
+// mcycle/minstret-style counters plus per-cause hazard counters.
+// All counters clear on reset and are read by the C++ harness through
+// the exported perf_dpi_read() (svSetScope on TOP.pipeline.perf_counters_inst).
+module perf_counters (
+    input logic       clk_i,
+    input logic       rst_i,
+
+    // The pipeline is frozen on a data cache miss: pipeline events below are
+    // re-presented every frozen cycle and are counted only once it moves on
+    input logic       freeze_i,
+
+    input logic       retire_w_i,     // Writeback holds an instruction, not a bubble
+    input logic       retire_w2_i,    // DUAL_ISSUE: ... and one in its second slot
+    input logic       fused_w_i,      // MACRO_FUSION: the first slot holds two instructions
+    input logic       load_use_stall_i,
+    input logic       branch_stall_i, // EARLY_BRANCH: Decode waits for a branch operand
+    input logic       branch_i,       // Conditional branch resolved in Execute
+    input logic       jump_i,         // JAL/JALR resolved in Execute
+    input logic       branch_flush_i, // ... and Fetch had to be redirected
+    input logic       jump_flush_i,
+    input logic [1:0] forward_a_i,
+    input logic [1:0] forward_b_i,
+
+    // Cache events (cache.sv pulses) and cycles spent waiting on a miss
+    input logic       icache_hit_i,
+    input logic       icache_miss_i,
+    input logic       icache_evict_i,
+    input logic       icache_stall_i,
+    input logic       dcache_hit_i,
+    input logic       dcache_miss_i,
+    input logic       dcache_evict_i,
+    input logic       dcache_stall_i,
+
+    // M extension: instructions leaving Execute and cycles the divider holds it
+    input logic       muldiv_i,
+    input logic       div_stall_i
+);
+
+    logic active;
+    assign active = !freeze_i;
+
+    logic [63:0] counters [`PERF_NUM_COUNTERS-1:0];
+
+    always_ff @(posedge clk_i) begin
+        if (rst_i) begin
+            for (int i = 0; i < `PERF_NUM_COUNTERS; i++)
+                counters[i] <= '0;
+        end else begin
+            counters[`PERF_CYCLES]         <= counters[`PERF_CYCLES] + 1;
+            counters[`PERF_INSTRET]        <= counters[`PERF_INSTRET] + 64'(active && retire_w_i) +
+                                              64'(active && retire_w2_i) + 64'(active && fused_w_i);
+            counters[`PERF_LOAD_USE_STALL] <= counters[`PERF_LOAD_USE_STALL] + 64'(active && load_use_stall_i);
+            counters[`PERF_BRANCH_FLUSH]   <= counters[`PERF_BRANCH_FLUSH] + 64'(active && branch_flush_i);
+            counters[`PERF_JUMP_FLUSH]     <= counters[`PERF_JUMP_FLUSH] + 64'(active && jump_flush_i);
+            counters[`PERF_FWD_A_FROM_W]   <= counters[`PERF_FWD_A_FROM_W] + 64'(active && forward_a_i == 2'b01);
+            counters[`PERF_FWD_A_FROM_M]   <= counters[`PERF_FWD_A_FROM_M] + 64'(active && forward_a_i == 2'b10);
+            counters[`PERF_FWD_B_FROM_W]   <= counters[`PERF_FWD_B_FROM_W] + 64'(active && forward_b_i == 2'b01);
+            counters[`PERF_FWD_B_FROM_M]   <= counters[`PERF_FWD_B_FROM_M] + 64'(active && forward_b_i == 2'b10);
+            counters[`PERF_BRANCHES]       <= counters[`PERF_BRANCHES] + 64'(active && branch_i);
+            counters[`PERF_JUMPS]          <= counters[`PERF_JUMPS] + 64'(active && jump_i);
+            counters[`PERF_ICACHE_HITS]    <= counters[`PERF_ICACHE_HITS] + 64'(icache_hit_i);
+            counters[`PERF_ICACHE_MISSES]  <= counters[`PERF_ICACHE_MISSES] + 64'(icache_miss_i);
+            counters[`PERF_ICACHE_EVICT]   <= counters[`PERF_ICACHE_EVICT] + 64'(icache_evict_i);
+            counters[`PERF_ICACHE_STALL]   <= counters[`PERF_ICACHE_STALL] + 64'(icache_stall_i);
+            counters[`PERF_DCACHE_HITS]    <= counters[`PERF_DCACHE_HITS] + 64'(dcache_hit_i);
+            counters[`PERF_DCACHE_MISSES]  <= counters[`PERF_DCACHE_MISSES] + 64'(dcache_miss_i);
+            counters[`PERF_DCACHE_EVICT]   <= counters[`PERF_DCACHE_EVICT] + 64'(dcache_evict_i);
+            counters[`PERF_DCACHE_STALL]   <= counters[`PERF_DCACHE_STALL] + 64'(dcache_stall_i);
+            counters[`PERF_MULDIV]         <= counters[`PERF_MULDIV] + 64'(active && muldiv_i);
+            counters[`PERF_DIV_STALL]      <= counters[`PERF_DIV_STALL] + 64'(active && div_stall_i);
+            counters[`PERF_BRANCH_STALL]   <= counters[`PERF_BRANCH_STALL] + 64'(active && branch_stall_i);
+            counters[`PERF_DUAL_ISSUE]     <= counters[`PERF_DUAL_ISSUE] + 64'(active && retire_w2_i);
+            counters[`PERF_FUSED]          <= counters[`PERF_FUSED] + 64'(active && fused_w_i);
+        end
+    end
+
+    export "DPI-C" function perf_dpi_read;
+    export "DPI-C" function perf_dpi_count;
+
+    function longint unsigned perf_dpi_read(input int index);
+        if (index < 0 || index >= `PERF_NUM_COUNTERS)
+            return 0;
+        return counters[index];
+    endfunction
+
+    function int perf_dpi_count();
+        return `PERF_NUM_COUNTERS;
+    endfunction
+
+endmodule
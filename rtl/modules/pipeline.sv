@@ -1,11 +1,30 @@
 `include "common/defines.svh"
 `include "common/opcodes.svh"
 `include "common/alu_defines.svh"
+`include "common/pipeline_stages.svh"
 
 module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DATA_MEM_INIT_FILE = "",
-                  parameter [`DATA_WIDTH-1:0] PC_START_ADDR = 64'h0) (
+                  parameter SPARSE_MEM = 0, parameter SINGLE_EDGE = 0,
+                  // 1: resolve branches and jumps in Decode (one-cycle redirect) instead of Execute
+                  parameter EARLY_BRANCH = 0,
+                  // 1: fetch two instructions per cycle and issue an independent integer
+                  // ALU instruction beside the first one (see g_dual_issue)
+                  parameter DUAL_ISSUE = 0,
+                  // 1: run lui+addi, auipc+jalr and slt+bne/beq pairs as one op (see fusion.sv)
+                  parameter MACRO_FUSION = 0,
+                  // 0: always predict fall-through, 1: bimodal, 2: gshare (see branch_predictor.sv)
+                  parameter BRANCH_PREDICTOR = 0, parameter BHT_BITS = 9, parameter BTB_BITS = 6,
+                  parameter RAS_BITS = 2,
+                  // Timing-only caches in front of ram_instr/ram_data (see cache.sv);
+                  // MEM_LATENCY is the backing memory latency of a line fill
+                  parameter ICACHE = 0, parameter ICACHE_SET_BITS = 6, parameter ICACHE_WAYS = 2,
+                  parameter ICACHE_LINE_BITS = 5,
+                  parameter DCACHE = 0, parameter DCACHE_SET_BITS = 6, parameter DCACHE_WAYS = 4,
+                  parameter DCACHE_LINE_BITS = 5,
+                  parameter CACHE_REPLACEMENT = 0, parameter MEM_LATENCY = 10) (
     input  logic clk_i,
     input  logic rst_i,
+    input  logic [`DATA_WIDTH-1:0] pc_start_i,
 
     output logic [`DATA_WIDTH-1:0] pc_f_o,
     output logic [`INSTR_WIDTH-1:0] instr_f_o,
@@ -16,42 +35,152 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
     output logic [`REG_ADDR_WIDTH-1:0] rs2_o,
     output logic [`DATA_WIDTH-1:0] rs2_val_o,
     output logic [`DATA_WIDTH-1:0] wd3_d_o,
-    output logic we3_d_o
+    output logic we3_d_o,
+    output logic [`REG_ADDR_WIDTH-1:0] wa3_d_o,
+    output logic [`DATA_WIDTH-1:0] pc_w_o,
+    // MACRO_FUSION: Writeback holds a fused pair, pc_w_o is its first instruction
+    output logic fused_w_o,
+    output logic halt_o,
+    // The store the data RAM takes at the next edge: Memory holds it and no
+    // stall keeps it there. The address and data are the ram_data port values.
+    output logic mem_we_m_o,
+    output logic [`DATA_WIDTH-1:0] mem_adr_m_o,
+    output logic [`DATA_WIDTH-1:0] mem_wd_m_o,
+    output logic [`DATA_WIDTH-1:0] pc_m_o,
+
+    // DUAL_ISSUE: the register write of Writeback's second slot, younger than
+    // the one above (we6_d_o is 0 in a single-issue pipeline)
+    output logic [`DATA_WIDTH-1:0] wd6_d_o,
+    output logic we6_d_o,
+    output logic [`REG_ADDR_WIDTH-1:0] wa6_d_o,
+    output logic [`DATA_WIDTH-1:0] pc_w2_o,
+
+    // Stage register contents for tracing: what Decode, Execute, Memory and
+    // Writeback hold in the current cycle
+    output if_id_t  if_id_o,
+    output id_ex_t  id_ex_o,
+    output ex_mem_t ex_mem_o,
+    output mem_wb_t mem_wb_o,
+    // ... and what happens to them at the next edge: stall_o ({W, M, E, D, F})
+    // holds a register, flush_o ({M, E, D}) clears it, and with redirect_o
+    // Fetch drops its instruction and restarts from the resolved PC
+    output logic [4:0] stall_o,
+    output logic [2:0] flush_o,
+    output logic redirect_o
 );
     // Fetch Stage
 
     logic [`DATA_WIDTH-1:0] pc_f_new;
     logic [`DATA_WIDTH-1:0] pc_f_prev;
     logic stall_f;
+    logic stall_d;
+    logic redirect_e;
+    logic redirect_d;
+    // Fetch restarts from the resolved next PC, of Execute or (EARLY_BRANCH) Decode
+    logic redirect_f;
+    logic [`DATA_WIDTH-1:0] redirect_pc_f;
+
+    // Fetch-time prediction, checked against the outcome in Execute (or Decode)
+    logic pred_taken_f;
+    logic [`DATA_WIDTH-1:0] pred_target_f;
 
     assign pc_f_o = pc_f_new;
 
+    // Second issue slot (DUAL_ISSUE = 1). Its stages are built in
+    // g_dual_issue at the end of the module; these are the signals the rest
+    // of the pipeline shares with it, all zero in a single-issue pipeline.
+    logic pair_f;
+    logic [`INSTR_WIDTH-1:0] instr2_f;
+    logic [`REG_ADDR_WIDTH-1:0] rs1_d2;
+    logic [`REG_ADDR_WIDTH-1:0] rs2_d2;
+    logic [`DATA_WIDTH-1:0] rs1_val_d2;
+    logic [`DATA_WIDTH-1:0] rs2_val_d2;
+    logic [`REG_ADDR_WIDTH-1:0] rs1_e2;
+    logic [`REG_ADDR_WIDTH-1:0] rs2_e2;
+    logic [`REG_ADDR_WIDTH-1:0] rd_e2;
+    logic reg_write_e2;
+    logic [`REG_ADDR_WIDTH-1:0] rd_m2;
+    logic reg_write_m2;
+    logic [`DATA_WIDTH-1:0] alu_result_m2;
+    logic [`REG_ADDR_WIDTH-1:0] rd_w2;
+    logic reg_write_w2;
+    logic [`DATA_WIDTH-1:0] wd6_d;
+    logic we6_d;
+    logic [`REG_ADDR_WIDTH-1:0] wa6_d;
+    logic [1:0] forward_a_e2;
+    logic [1:0] forward_b_e2;
+    logic forward_slot_a_e;
+    logic forward_slot_b_e;
+    logic forward_slot_a_e2;
+    logic forward_slot_b_e2;
+
+    // A redirect overrides a stall in Fetch: the instruction being fetched
+    // is on the wrong path and gets flushed anyway
     flopenr #(`DATA_WIDTH)
     flopenr_pc_f_prev(
         .clk(clk_i),
         .reset(1'b0),
-        .en(!stall_f),
+        .en(!stall_f || redirect_f),
         .d(pc_f_prev),
         .q(pc_f_new));
 
     logic [`INSTR_WIDTH-1:0] instr_f;
     assign instr_f_o = instr_f;
+    logic [`DATA_WIDTH-1:0] pc_4_f;
 
+    // DUAL_ISSUE and MACRO_FUSION read the following instruction through a second port
     ram #(
         .N(`RAM_REAL_SIZE),
         .M(`INSTR_WIDTH),
         .OFFSET_BITS(2),
         .ADR_WIDTH(`DATA_WIDTH),
-        .INIT_FILE(INSTR_MEM_INIT_FILE)
+        .INIT_FILE(INSTR_MEM_INIT_FILE),
+        .INIT_PLUSARG("instr_mem"),
+        .SPARSE(SPARSE_MEM),
+        .READ_PORT2(DUAL_ISSUE != 0 || MACRO_FUSION != 0)
     ) ram_instr(
         .clk(clk_i),
         .we(1'b0),
         .adr(pc_f_new),
         .din({`INSTR_WIDTH{1'b0}}),
-        .dout(instr_f)
+        .dout(instr_f),
+        .adr2(pc_4_f),
+        .dout2(instr2_f)
     );
 
-    logic [`DATA_WIDTH-1:0] pc_4_f;
+    // Instruction cache miss: Fetch holds its PC and Decode receives bubbles
+    logic icache_stall_f;
+    logic icache_hit;
+    logic icache_miss;
+    logic icache_evict;
+
+    generate
+        if (ICACHE != 0) begin : g_icache
+            cache #(
+                .SET_BITS(ICACHE_SET_BITS),
+                .WAYS(ICACHE_WAYS),
+                .LINE_BITS(ICACHE_LINE_BITS),
+                .REPLACEMENT(CACHE_REPLACEMENT),
+                .MISS_LATENCY(MEM_LATENCY)
+            ) icache(
+                .clk_i(clk_i),
+                .rst_i(rst_i),
+                .req_i(!rst_i),
+                .we_i(1'b0),
+                .hold_i(stall_d || redirect_f),
+                .adr_i(pc_f_new),
+                .stall_o(icache_stall_f),
+                .hit_o(icache_hit),
+                .miss_o(icache_miss),
+                .evict_o(icache_evict)
+            );
+        end else begin : g_no_icache
+            assign icache_stall_f = 1'b0;
+            assign icache_hit = 1'b0;
+            assign icache_miss = 1'b0;
+            assign icache_evict = 1'b0;
+        end
+    endgenerate
 
     alu pc_4_alu(
         .operand_a(pc_f_new),
@@ -61,42 +190,111 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
         .result(pc_4_f)
     );
 
-    // Flopenr Registers between Fetch and Decode
+    // Both instructions of a pair or a fused op must share an ICACHE line, as
+    // the cache model only looks up pc_f_new. Fetch then moves on by two.
+    logic same_line_f;
+    logic [`DATA_WIDTH-1:0] pc_8_f;
+    assign same_line_f = (ICACHE == 0) || (pc_f_new[ICACHE_LINE_BITS-1:2] != '1);
+
+    generate
+        if (DUAL_ISSUE != 0 || MACRO_FUSION != 0) begin : g_pc_8
+            alu pc_8_alu(
+                .operand_a(pc_f_new),
+                .operand_b(8),
+                .alu_op_select(`ALU_OP_ADD),
+                .alu_modifier(`ALU_SELECT_SIGNED),
+                .result(pc_8_f)
+            );
+        end else begin : g_no_pc_8
+            assign pc_8_f = '0;
+        end
+    endgenerate
+
+    // Macro-op fusion: the instruction at pc_4_f is folded into the one at pc_f_new
+    logic fuse_f;
+
+    generate
+        if (MACRO_FUSION != 0) begin : g_fuse
+            fusion fusion_f(
+                .instr_i(instr_f),
+                .next_i(instr2_f),
+                .fuse_o(fuse_f),
+                .jump_o(),
+                .branch_o(),
+                .branch_funct3_o(),
+                .imm_o()
+            );
+        end else begin : g_no_fuse
+            assign fuse_f = 1'b0;
+        end
+    endgenerate
+
+    // Pairing: the instruction at pc_4_f issues beside the one at pc_f_new
+    // when it is an integer ALU instruction (OP or OP-IMM, no M extension),
+    // does not read the first one's rd, and the first one cannot redirect
+    // Fetch or halt and is not fused.
+    generate
+        if (DUAL_ISSUE != 0) begin : g_pair
+            logic [6:0] op1_f;
+            logic [6:0] op2_f;
+            logic [`REG_ADDR_WIDTH-1:0] rd1_f;
+            logic first_ok_f;
+            logic second_alu_f;
+            logic independent_f;
+            assign op1_f = instr_f[6:0];
+            assign op2_f = instr2_f[6:0];
+            assign rd1_f = instr_f[11:7];
+            assign first_ok_f = (op1_f != `OPCODE_BRANCH) && (op1_f != `OPCODE_JAL) &&
+                                (op1_f != `OPCODE_JALR) && (op1_f != `OPCODE_SYSTEM) && !pred_taken_f;
+            assign second_alu_f = (op2_f == `OPCODE_I_ALU) || (op2_f == `OPCODE_R_ALU && !instr2_f[25]);
+            // rs2 of an OP-IMM instruction is immediate bits: compared anyway
+            assign independent_f = (rd1_f == '0) ||
+                                   ((instr2_f[19:15] != rd1_f) && (instr2_f[24:20] != rd1_f));
+            assign pair_f = first_ok_f && second_alu_f && independent_f && same_line_f && !fuse_f;
+        end else begin : g_no_pair
+            assign pair_f = 1'b0;
+        end
+    endgenerate
+
+    // Register between Fetch and Decode
 
-    logic stall_d;
     logic flush_d;
 
-    logic [`INSTR_WIDTH-1:0] instr_d;
-    logic [`DATA_WIDTH-1:0] pc_d;
-    logic [`DATA_WIDTH-1:0] pc_4_d;
+    if_id_t if_id_next;
+    if_id_t if_id;
 
+    logic fused_f;
+    assign fused_f = fuse_f && same_line_f;
 
-    flopenr #(`INSTR_WIDTH)
-    flopenr_instr_f(
-        .clk(clk_i),
-        .reset(flush_d || rst_i),
-        .en(!stall_d),
-        .d(instr_f),
-        .q(instr_d)
-    );
+    assign if_id_next.pc = pc_f_new;
+    // A fused op falls through (and links) past both of its instructions
+    assign if_id_next.pc_4 = fused_f ? pc_8_f : pc_4_f;
+    assign if_id_next.instr = instr_f;
+    assign if_id_next.instr2 = fused_f ? instr2_f : '0;
+    assign if_id_next.pred_target = pred_target_f;
+    assign if_id_next.pred_taken = pred_taken_f;
+    assign if_id_next.fused = fused_f;
 
-    flopenr #(`DATA_WIDTH)
-    flopenr_pc_4_f(
+    flopenr #($bits(if_id_t))
+    flopenr_if_id(
         .clk(clk_i),
         .reset(flush_d || rst_i),
         .en(!stall_d),
-        .d(pc_4_f),
-        .q(pc_4_d)
+        .d(if_id_next),
+        .q(if_id)
     );
+    assign if_id_o = if_id;
 
-    flopenr #(`DATA_WIDTH)
-    flopenr_pc_f(
-        .clk(clk_i),
-        .reset(flush_d || rst_i),
-        .en(!stall_d),
-        .d(pc_f_new),
-        .q(pc_d)
-    );
+    logic [`INSTR_WIDTH-1:0] instr_d;
+    logic [`DATA_WIDTH-1:0] pc_d;
+    logic [`DATA_WIDTH-1:0] pc_4_d;
+    assign instr_d = if_id.instr;
+    assign pc_d = if_id.pc;
+    assign pc_4_d = if_id.pc_4;
+    logic pred_taken_d;
+    logic [`DATA_WIDTH-1:0] pred_target_d;
+    assign pred_taken_d = if_id.pred_taken;
+    assign pred_target_d = if_id.pred_target;
 
     // Decode Stage
 
@@ -112,14 +310,16 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
     assign rd_o = rd_d;
     logic [`DATA_WIDTH-1:0] imm_d;
     logic [`INSTR_WIDTH-1:0] imm_d_32;
-    assign imm_d = {{(`DATA_WIDTH-`INSTR_WIDTH){imm_d_32[31]}}, imm_d_32};
     assign imm_o = imm_d;
     logic reg_write_d;
     logic [1:0] result_src_d;
     logic mem_write_d;
     logic jump_d;
     logic branch_d;
+    logic [2:0] funct3_d;
     logic [3:0] alu_control_d;
+    logic muldiv_d;
+    logic [3:0] muldiv_op_d;
     logic alu_src_d;
     logic [1:0] imm_src_d;
     logic [`REG_ADDR_WIDTH-1:0] wa3_d;
@@ -127,37 +327,107 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
     logic we3_d;
     assign wd3_d_o = wd3_d;
     assign we3_d_o = we3_d;
+    assign wa3_d_o = wa3_d;
     logic is_u_type_d;
+    logic [1:0] result_src_cu_d;
+    logic jump_cu_d;
+    logic branch_cu_d;
 
     control_unit cu(
         .op_i(instr_d[6:0]),
         .funct3_i(instr_d[14:12]),
         .funct7_5_i(instr_d[30]),
+        .funct7_0_i(instr_d[25]),
 
         .RegWriteD_o(reg_write_d),
-        .ResultSrcD_o(result_src_d),
+        .ResultSrcD_o(result_src_cu_d),
         .MemWriteD_o(mem_write_d),
-        .JumpD_o(jump_d),
-        .BranchD_o(branch_d),
+        .JumpD_o(jump_cu_d),
+        .BranchD_o(branch_cu_d),
         .ALUSrcD_o(alu_src_d),
         .ImmSelD_o(imm_src_d),
         .Is_U_typeD_o(is_u_type_d),
         .ALUControlD_o(alu_control_d[2:0]),
-        .ALUModifierD_o(alu_control_d[3])
+        .ALUModifierD_o(alu_control_d[3]),
+        .MulDivD_o(muldiv_d),
+        .MulDivOpD_o(muldiv_op_d)
     );
 
-    regfile regfile(
-        .clk(!clk_i),
+    // Macro-op fusion: a fused op is its first instruction as control_unit
+    // decodes it, with the immediate of the pair and, for auipc + jalr and
+    // slt + bne/beq, made a jump (linking pc + 8) or also a branch
+    logic fused_d;
+    logic fused_jump_d;
+    logic fused_branch_d;
+    logic [2:0] fused_funct3_d;
+    logic [`DATA_WIDTH-1:0] fused_imm_d;
+    assign fused_d = if_id.fused;
+
+    generate
+        if (MACRO_FUSION != 0) begin : g_fusion
+            fusion fusion_d(
+                .instr_i(instr_d),
+                .next_i(if_id.instr2),
+                .fuse_o(),
+                .jump_o(fused_jump_d),
+                .branch_o(fused_branch_d),
+                .branch_funct3_o(fused_funct3_d),
+                .imm_o(fused_imm_d)
+            );
+        end else begin : g_no_fusion
+            assign fused_jump_d = 1'b0;
+            assign fused_branch_d = 1'b0;
+            assign fused_funct3_d = '0;
+            assign fused_imm_d = '0;
+        end
+    endgenerate
+
+    assign jump_d = jump_cu_d || (fused_d && fused_jump_d);
+    assign branch_d = branch_cu_d || (fused_d && fused_branch_d);
+    assign result_src_d = (fused_d && fused_jump_d) ? `RESSRC_PC4 : result_src_cu_d;
+    assign funct3_d = (fused_d && fused_branch_d) ? fused_funct3_d : instr_d[14:12];
+
+    // LUI and AUIPC take the U-type immediate and read no register: LUI adds
+    // it to x0, AUIPC to the PC (pc_rel, Execute's PC adder)
+    logic [`DATA_WIDTH-1:0] imm_base_d;
+    assign imm_base_d = is_u_type_d ? {{(`DATA_WIDTH-32){instr_d[31]}}, instr_d[31:12], 12'b0} :
+                                      {{(`DATA_WIDTH-`INSTR_WIDTH){imm_d_32[31]}}, imm_d_32};
+    assign imm_d = fused_d ? fused_imm_d : imm_base_d;
+
+    logic pc_rel_d;
+    assign pc_rel_d = (instr_d[6:0] == `OPCODE_AUIPC) && !fused_d;
+
+    // SINGLE_EDGE = 1: posedge regfile with a Writeback-to-Decode bypass, so
+    // nothing in the pipeline is sensitive to the falling edge of clk_i
+    regfile #(
+        .POSEDGE_BYPASS(SINGLE_EDGE)
+    ) regfile(
+        .clk(SINGLE_EDGE ? clk_i : !clk_i),
         .we3(we3_d),
-        .a1(instr_d[19:15]),
-        .a2(instr_d[24:20]),
+        .a1(rs1_d),
+        .a2(rs2_d),
         .a3(wa3_d),
         .wd3(wd3_d),
         .rd1(rs1_val_d),
-        .rd2(rs2_val_d)
+        .rd2(rs2_val_d),
+        .we6(we6_d),
+        .a4(rs1_d2),
+        .a5(rs2_d2),
+        .a6(wa6_d),
+        .wd6(wd6_d),
+        .rd4(rs1_val_d2),
+        .rd5(rs2_val_d2)
     );
 
-    assign rs1_d = instr_d[19:15];
+    // SYSTEM instructions (ecall/ebreak/xret) end the program once they reach Writeback
+    logic halt_d;
+    assign halt_d = (instr_d[6:0] == `OPCODE_SYSTEM);
+
+    // Tells calls and returns apart from plain jumps for the return address stack
+    logic jalr_d;
+    assign jalr_d = (instr_d[6:0] == `OPCODE_JALR);
+
+    assign rs1_d = is_u_type_d ? '0 : instr_d[19:15];
     assign rs2_d = instr_d[24:20];
     assign rd_d = instr_d[11:7];
 
@@ -167,16 +437,138 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
         .immext(imm_d_32)
     );
 
-    // Flopr Registers between Decode and Execute
-
+    // Early branch resolution (EARLY_BRANCH = 1): a comparator and target
+    // adders in Decode redirect Fetch one cycle after the branch was fetched,
+    // flushing only the instruction behind it. Operands come from the
+    // register file (Writeback has written it by now) or from Memory's ALU
+    // result; hazard_unit stalls the branch while a source is still in
+    // Execute or is a load or a product in Memory.
+    logic [`DATA_WIDTH-1:0] alu_result_m;
+    logic forward_a_d;
+    logic forward_b_d;
+    logic branch_operands_d;
+    logic [`DATA_WIDTH-1:0] redirect_pc_d;
+
+    assign branch_operands_d = (EARLY_BRANCH != 0) && (branch_d || jalr_d);
+
+    generate
+        if (EARLY_BRANCH != 0) begin : g_early_branch
+            logic [`DATA_WIDTH-1:0] branch_a_d;
+            logic [`DATA_WIDTH-1:0] branch_b_d;
+
+            mux2 #(.WIDTH(`DATA_WIDTH))
+            mux2_branch_a_d(
+                .data0_i(rs1_val_d),
+                .data1_i(alu_result_m),
+                .sel_i(forward_a_d),
+                .data_o(branch_a_d)
+            );
+
+            mux2 #(.WIDTH(`DATA_WIDTH))
+            mux2_branch_b_d(
+                .data0_i(rs2_val_d),
+                .data1_i(alu_result_m),
+                .sel_i(forward_b_d),
+                .data_o(branch_b_d)
+            );
+
+            logic cond_d;
+            branch_unit branch_unit_d(
+                .funct3_i(funct3_d),
+                .a_i(branch_a_d),
+                .b_i(branch_b_d),
+                .taken_o(cond_d)
+            );
+
+            logic [`DATA_WIDTH-1:0] pc_imm_d;
+            logic [`DATA_WIDTH-1:0] rs1_imm_d;
+
+            alu pc_alu_d(
+                .operand_a(pc_d),
+                .operand_b(imm_d),
+                .alu_op_select(`ALU_OP_ADD),
+                .alu_modifier(`ALU_SELECT_SIGNED),
+                .result(pc_imm_d)
+            );
+
+            alu jalr_alu_d(
+                .operand_a(branch_a_d),
+                .operand_b(imm_d),
+                .alu_op_select(`ALU_OP_ADD),
+                .alu_modifier(`ALU_SELECT_SIGNED),
+                .result(rs1_imm_d)
+            );
+
+            logic taken_d;
+            logic [`DATA_WIDTH-1:0] target_d;
+            assign taken_d = jump_d || (branch_d && cond_d);
+            // Bit 0 is cleared for a fused auipc + jalr as well
+            assign target_d = jalr_d ? {rs1_imm_d[`DATA_WIDTH-1:1], 1'b0} : {pc_imm_d[`DATA_WIDTH-1:1], 1'b0};
+
+            assign redirect_d = (branch_d || jump_d) && !stall_d &&
+                                ((taken_d != pred_taken_d) || (taken_d && (pred_target_d != target_d)));
+            assign redirect_pc_d = taken_d ? target_d : pc_4_d;
+        end else begin : g_late_branch
+            assign redirect_d = 1'b0;
+            assign redirect_pc_d = '0;
+        end
+    endgenerate
+
+    // Register between Decode and Execute
+
+    logic stall_e;
     logic flush_e;
 
+    id_ex_t id_ex_next;
+    id_ex_t id_ex;
+
+    assign id_ex_next.pc = pc_d;
+    assign id_ex_next.pc_4 = pc_4_d;
+    assign id_ex_next.imm = imm_d;
+    assign id_ex_next.rd1 = rs1_val_d;
+    assign id_ex_next.rd2 = rs2_val_d;
+    assign id_ex_next.rs1 = rs1_d;
+    assign id_ex_next.rs2 = rs2_d;
+    assign id_ex_next.rd = rd_d;
+    assign id_ex_next.alu_control = alu_control_d;
+    assign id_ex_next.funct3 = funct3_d;
+    assign id_ex_next.muldiv_op = muldiv_op_d;
+    assign id_ex_next.muldiv = muldiv_d;
+    assign id_ex_next.result_src = result_src_d;
+    assign id_ex_next.reg_write = reg_write_d;
+    assign id_ex_next.mem_write = mem_write_d;
+    assign id_ex_next.jump = jump_d;
+    assign id_ex_next.branch = branch_d;
+    assign id_ex_next.alu_src = alu_src_d;
+    assign id_ex_next.halt = halt_d;
+    assign id_ex_next.jalr = jalr_d;
+    assign id_ex_next.pc_rel = pc_rel_d;
+    assign id_ex_next.fused = fused_d;
+    assign id_ex_next.pred_target = pred_target_d;
+    assign id_ex_next.pred_taken = pred_taken_d;
+
+    // Reset empties every stage register, not only Decode's: a model that
+    // has already run must start from a drained pipeline (see the harness's
+    // load_arch_state), and a store still in Memory must not write
+    flopenr #($bits(id_ex_t))
+    flopenr_id_ex(
+        .clk(clk_i),
+        .reset(flush_e || rst_i),
+        .en(!stall_e),
+        .d(id_ex_next),
+        .q(id_ex)
+    );
+    assign id_ex_o = id_ex;
+
     logic reg_write_e;
     logic [1:0] result_src_e;
     logic mem_write_e;
     logic jump_e;
     logic branch_e;
     logic [3:0] alu_control_e;
+    logic [2:0] funct3_e;
+    logic muldiv_e;
+    logic [3:0] muldiv_op_e;
     logic alu_src_e;
     logic [`DATA_WIDTH-1:0] rd1_e;
     logic [`DATA_WIDTH-1:0] rd2_e;
@@ -186,130 +578,39 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
     logic [`REG_ADDR_WIDTH-1:0] rd_e;
     logic [`DATA_WIDTH-1:0] imm_e;
     logic [`DATA_WIDTH-1:0] pc_4_e;
-
-    flopr #(.WIDTH(1))
-    flopr_reg_write_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(reg_write_d),
-        .q(reg_write_e)
-    );
-
-    flopr #(.WIDTH(2))
-    flopr_result_src_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(result_src_d),
-        .q(result_src_e)
-    );
-
-    flopr #(.WIDTH(1))
-    flopr_mem_write_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(mem_write_d),
-        .q(mem_write_e)
-    );
-
-    flopr #(.WIDTH(1))
-    flopr_jump_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(jump_d),
-        .q(jump_e)
-    );
-
-    flopr #(.WIDTH(1))
-    flopr_branch_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(branch_d),
-        .q(branch_e)
-    );
-
-    flopr #(.WIDTH(4))
-    flopr_alu_control_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(alu_control_d),
-        .q(alu_control_e)
-    );
-
-    flopr #(.WIDTH(1))
-    flopr_alu_src_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(alu_src_d),
-        .q(alu_src_e)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_rd1_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(rs1_val_d),
-        .q(rd1_e)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_rd2_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(rs2_val_d),
-        .q(rd2_e)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_pc_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(pc_d),
-        .q(pc_e)
-    );
-
-    flopr #(.WIDTH(`REG_ADDR_WIDTH))
-    flopr_rs1_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(rs1_d),
-        .q(rs1_e)
-    );
-
-    flopr #(.WIDTH(`REG_ADDR_WIDTH))
-    flopr_rs2_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(rs2_d),
-        .q(rs2_e)
-    );
-
-    flopr #(.WIDTH(`REG_ADDR_WIDTH))
-    flopr_rd_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(rd_d),
-        .q(rd_e)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_imm_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(imm_d),
-        .q(imm_e)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_pc_4_e(
-        .clk(clk_i),
-        .reset(flush_e),
-        .d(pc_4_d),
-        .q(pc_4_e)
-    );
+    logic halt_e;
+    logic jalr_e;
+    logic pc_rel_e;
+    logic fused_e;
+    logic pred_taken_e;
+    logic [`DATA_WIDTH-1:0] pred_target_e;
+    assign reg_write_e = id_ex.reg_write;
+    assign result_src_e = id_ex.result_src;
+    assign mem_write_e = id_ex.mem_write;
+    assign jump_e = id_ex.jump;
+    assign branch_e = id_ex.branch;
+    assign alu_control_e = id_ex.alu_control;
+    assign funct3_e = id_ex.funct3;
+    assign muldiv_e = id_ex.muldiv;
+    assign muldiv_op_e = id_ex.muldiv_op;
+    assign alu_src_e = id_ex.alu_src;
+    assign rd1_e = id_ex.rd1;
+    assign rd2_e = id_ex.rd2;
+    assign pc_e = id_ex.pc;
+    assign rs1_e = id_ex.rs1;
+    assign rs2_e = id_ex.rs2;
+    assign rd_e = id_ex.rd;
+    assign imm_e = id_ex.imm;
+    assign pc_4_e = id_ex.pc_4;
+    assign halt_e = id_ex.halt;
+    assign jalr_e = id_ex.jalr;
+    assign pred_taken_e = id_ex.pred_taken;
+    assign pred_target_e = id_ex.pred_target;
+    assign pc_rel_e = id_ex.pc_rel;
+    assign fused_e = id_ex.fused;
 
     // Execute Stage
 
-    logic [`DATA_WIDTH-1:0] alu_result_m;
     logic [`DATA_WIDTH-1:0] alu_operand_a_e;
     logic [`DATA_WIDTH-1:0] alu_operand_b_reg;
     logic [`DATA_WIDTH-1:0] alu_operand_b_e;
@@ -319,15 +620,24 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
     logic [`DATA_WIDTH-1:0] alu_result_e;
     logic [`DATA_WIDTH-1:0] write_data_e;
     assign write_data_e = alu_operand_b_reg;
+    logic [`DATA_WIDTH-1:0] pc_imm_e;
     logic [`DATA_WIDTH-1:0] pc_target_e;
 
-
+    // Results in flight in Memory and Writeback, from the slot hazard_unit picked
+    logic [`DATA_WIDTH-1:0] forward_m_a_e;
+    logic [`DATA_WIDTH-1:0] forward_w_a_e;
+    logic [`DATA_WIDTH-1:0] forward_m_b_e;
+    logic [`DATA_WIDTH-1:0] forward_w_b_e;
+    assign forward_m_a_e = forward_slot_a_e ? alu_result_m2 : alu_result_m;
+    assign forward_w_a_e = forward_slot_a_e ? wd6_d : wd3_d;
+    assign forward_m_b_e = forward_slot_b_e ? alu_result_m2 : alu_result_m;
+    assign forward_w_b_e = forward_slot_b_e ? wd6_d : wd3_d;
 
     mux3 #(.WIDTH(`DATA_WIDTH))
     mux3_alu_operand_a_e(
         .data0_i(rd1_e),
-        .data1_i(wd3_d),
-        .data2_i(alu_result_m),
+        .data1_i(forward_w_a_e),
+        .data2_i(forward_m_a_e),
         .sel_i(forward_a_e),
         .data_o(alu_operand_a_e)
     );
@@ -335,8 +645,8 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
     mux3 #(.WIDTH(`DATA_WIDTH))
     mux3_alu_operand_b_e(
         .data0_i(rd2_e),
-        .data1_i(wd3_d),
-        .data2_i(alu_result_m),
+        .data1_i(forward_w_b_e),
+        .data2_i(forward_m_b_e),
         .sel_i(forward_b_e),
         .data_o(alu_operand_b_reg)
     );
@@ -363,78 +673,127 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
         .operand_b(imm_e),
         .alu_op_select(`ALU_OP_ADD),
         .alu_modifier(`ALU_SELECT_SIGNED),
-        .result(pc_target_e)
+        .result(pc_imm_e)
     );
 
-    logic pc_src_e;
-    assign pc_src_e = (zero_flag_e && branch_e) || jump_e;
-
-    // Registers between execute and memory
-
-    logic reg_write_m;
-    logic [1:0] result_src_m;
-    logic mem_write_m;
-
-    logic [`DATA_WIDTH-1:0] write_data_m;
-    logic [`REG_ADDR_WIDTH-1:0] rd_m;
-    logic [`DATA_WIDTH-1:0] pc_4_m;
-    logic flush_m = 1'b0;
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_reg_write_m(
-        .clk(clk_i),
-        .reset(flush_m),
-        .d(reg_write_e),
-        .q(reg_write_m)
+    // JALR jumps to rs1 + imm (the main ALU's sum) with bit 0 cleared, and so
+    // does a fused auipc + jalr through the PC adder
+    mux2 #(.WIDTH(`DATA_WIDTH))
+    mux2_pc_target_e(
+        .data0_i({pc_imm_e[`DATA_WIDTH-1:1], 1'b0}),
+        .data1_i({alu_result_e[`DATA_WIDTH-1:1], 1'b0}),
+        .sel_i(jalr_e),
+        .data_o(pc_target_e)
     );
 
-    flopr #(.WIDTH(2))
-    flopr_result_src_m(
-        .clk(clk_i),
-        .reset(flush_m),
-        .d(result_src_e),
-        .q(result_src_m)
+    logic branch_cond_e;
+    branch_unit branch_unit_e(
+        .funct3_i(funct3_e),
+        .a_i(alu_operand_a_e),
+        .b_i(alu_operand_b_reg),
+        .taken_o(branch_cond_e)
     );
 
-    flopr #(.WIDTH(1))
-    flopr_mem_write_m(
-        .clk(clk_i),
-        .reset(flush_m),
-        .d(mem_write_e),
-        .q(mem_write_m)
+    // M extension. Products finish in Memory (RESSRC_MUL); a division keeps
+    // Execute busy until its result can take the ALU's place on the way to Memory.
+    logic [`DATA_WIDTH-1:0] mul_result_m;
+    logic stall_m;
+
+    multiplier multiplier_inst(
+        .clk_i(clk_i),
+        .en_i(!stall_m),
+        .op_i(muldiv_op_e),
+        .a_i(alu_operand_a_e),
+        .b_i(alu_operand_b_reg),
+        .result_o(mul_result_m)
     );
 
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_alu_result_m(
-        .clk(clk_i),
-        .reset(flush_m),
-        .d(alu_result_e),
-        .q(alu_result_m)
+    logic div_e;
+    logic div_busy_e;
+    logic [`DATA_WIDTH-1:0] div_result_e;
+    assign div_e = muldiv_e && muldiv_op_e[2];
+
+    divider divider_inst(
+        .clk_i(clk_i),
+        .rst_i(rst_i),
+        .start_i(div_e),
+        .hold_i(stall_m),
+        .op_i(muldiv_op_e),
+        .a_i(alu_operand_a_e),
+        .b_i(alu_operand_b_reg),
+        .busy_o(div_busy_e),
+        .result_o(div_result_e)
     );
 
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_write_data_m(
-        .clk(clk_i),
-        .reset(flush_m),
-        .d(write_data_e),
-        .q(write_data_m)
-    );
+    // Jumps pass their link address (and AUIPC its PC-relative sum) on in
+    // place of the ALU result, so that Memory forwards it like any other result
+    logic [`DATA_WIDTH-1:0] ex_result_e;
+    assign ex_result_e = div_e ? div_result_e : jump_e ? pc_4_e : pc_rel_e ? pc_imm_e : alu_result_e;
 
-    flopr #(.WIDTH(`REG_ADDR_WIDTH))
-    flopr_rd_m(
+    logic pc_src_e;
+    assign pc_src_e = (branch_cond_e && branch_e) || jump_e;
+
+    // Fetch went the wrong way (direction or target): restart it from the
+    // resolved next PC and flush Decode and Execute. Without a predictor this
+    // is every taken branch and jump. With EARLY_BRANCH, Decode has already
+    // done this and Execute only computes the outcome for the predictor.
+    logic [`DATA_WIDTH-1:0] redirect_pc_e;
+    // While Execute is held (data cache miss, division), the redirect waits with it
+    assign redirect_e = (EARLY_BRANCH == 0) && !stall_e &&
+                        ((pc_src_e != pred_taken_e) || (pc_src_e && (pred_target_e != pc_target_e)));
+    assign redirect_pc_e = pc_src_e ? pc_target_e : pc_4_e;
+
+    // RISC-V calling convention hints: rd = ra/t0 is a call, jalr through ra/t0 a return
+    logic call_e;
+    logic return_e;
+    assign call_e = jump_e && (rd_e == 5'd1 || rd_e == 5'd5);
+    assign return_e = jalr_e && !call_e && (rs1_e == 5'd1 || rs1_e == 5'd5);
+
+    // Register between Execute and Memory
+
+    // A busy divider sends bubbles into Memory
+    logic flush_m;
+
+    ex_mem_t ex_mem_next;
+    ex_mem_t ex_mem;
+
+    assign ex_mem_next.pc_4 = pc_4_e;
+    assign ex_mem_next.alu_result = ex_result_e;
+    assign ex_mem_next.write_data = write_data_e;
+    assign ex_mem_next.rd = rd_e;
+    assign ex_mem_next.result_src = result_src_e;
+    assign ex_mem_next.reg_write = reg_write_e;
+    assign ex_mem_next.mem_write = mem_write_e;
+    assign ex_mem_next.halt = halt_e;
+    assign ex_mem_next.fused = fused_e;
+
+    flopenr #($bits(ex_mem_t))
+    flopenr_ex_mem(
         .clk(clk_i),
-        .reset(flush_m),
-        .d(rd_e),
-        .q(rd_m)
+        .reset(flush_m || rst_i),
+        .en(!stall_m),
+        .d(ex_mem_next),
+        .q(ex_mem)
     );
+    assign ex_mem_o = ex_mem;
 
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_pc_4_m(
-        .clk(clk_i),
-        .reset(flush_m),
-        .d(pc_4_e),
-        .q(pc_4_m)
-    );
+    logic reg_write_m;
+    logic [1:0] result_src_m;
+    logic mem_write_m;
+    logic [`DATA_WIDTH-1:0] write_data_m;
+    logic [`REG_ADDR_WIDTH-1:0] rd_m;
+    logic [`DATA_WIDTH-1:0] pc_4_m;
+    logic halt_m;
+    logic fused_m;
+    assign reg_write_m = ex_mem.reg_write;
+    assign result_src_m = ex_mem.result_src;
+    assign mem_write_m = ex_mem.mem_write;
+    assign alu_result_m = ex_mem.alu_result;
+    assign write_data_m = ex_mem.write_data;
+    assign rd_m = ex_mem.rd;
+    assign pc_4_m = ex_mem.pc_4;
+    assign halt_m = ex_mem.halt;
+    assign fused_m = ex_mem.fused;
 
     // Memory Stage
 
@@ -445,79 +804,121 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
         .N(`RAM_REAL_SIZE),
         .ADR_WIDTH(`DATA_WIDTH),
         .OFFSET_BITS(3),
-        .INIT_FILE(DATA_MEM_INIT_FILE)
+        .INIT_FILE(DATA_MEM_INIT_FILE),
+        .INIT_PLUSARG("data_mem"),
+        .SPARSE(SPARSE_MEM)
     ) ram_data(
         .clk(clk_i),
-        .we(mem_write_m),
+        .we(mem_write_m && !stall_m && !rst_i),
         .adr(alu_result_m),
         .din(write_data_m),
-        .dout(read_data_m)
+        .dout(read_data_m),
+        .adr2('0),
+        .dout2()
     );
 
-    // Registers between memory and writeback
+    // Data cache read miss: the whole pipeline waits, Writeback included, so
+    // that Execute keeps its forwarding sources until the load completes
+    logic dcache_stall_m;
+    logic dcache_hit;
+    logic dcache_miss;
+    logic dcache_evict;
+
+    generate
+        if (DCACHE != 0) begin : g_dcache
+            cache #(
+                .SET_BITS(DCACHE_SET_BITS),
+                .WAYS(DCACHE_WAYS),
+                .LINE_BITS(DCACHE_LINE_BITS),
+                .REPLACEMENT(CACHE_REPLACEMENT),
+                .MISS_LATENCY(MEM_LATENCY)
+            ) dcache(
+                .clk_i(clk_i),
+                .rst_i(rst_i),
+                .req_i(!rst_i && (result_src_m == `RESSRC_MEM || mem_write_m)),
+                .we_i(mem_write_m),
+                .hold_i(1'b0),
+                .adr_i(alu_result_m),
+                .stall_o(dcache_stall_m),
+                .hit_o(dcache_hit),
+                .miss_o(dcache_miss),
+                .evict_o(dcache_evict)
+            );
+        end else begin : g_no_dcache
+            assign dcache_stall_m = 1'b0;
+            assign dcache_hit = 1'b0;
+            assign dcache_miss = 1'b0;
+            assign dcache_evict = 1'b0;
+        end
+    endgenerate
+
+    // Register between Memory and Writeback
+
+    logic stall_w;
+    logic flush_w = 1'b0;
+
+    mem_wb_t mem_wb_next;
+    mem_wb_t mem_wb;
+
+    assign mem_wb_next.pc_4 = pc_4_m;
+    // A product replaces the (unused) ALU result; Writeback's result mux
+    // reads alu_result for RESSRC_MUL as it does for RESSRC_ALU
+    assign mem_wb_next.alu_result = (result_src_m == `RESSRC_MUL) ? mul_result_m : alu_result_m;
+    assign mem_wb_next.read_data = read_data_m;
+    assign mem_wb_next.rd = rd_m;
+    assign mem_wb_next.result_src = result_src_m;
+    assign mem_wb_next.reg_write = reg_write_m;
+    assign mem_wb_next.halt = halt_m;
+    assign mem_wb_next.fused = fused_m;
+
+    flopenr #($bits(mem_wb_t))
+    flopenr_mem_wb(
+        .clk(clk_i),
+        .reset(flush_w || rst_i),
+        .en(!stall_w),
+        .d(mem_wb_next),
+        .q(mem_wb)
+    );
+    assign mem_wb_o = mem_wb;
+
     logic reg_write_w;
     logic [1:0] result_src_w;
-
     logic [`DATA_WIDTH-1:0] alu_result_w;
     logic [`DATA_WIDTH-1:0] read_data_w;
     logic [`REG_ADDR_WIDTH-1:0] rd_w;
     logic [`DATA_WIDTH-1:0] pc_4_w;
-    logic flush_w = 1'b0;
-
-    flopr #(.WIDTH(1))
-    flopr_reg_write_w(
-        .clk(clk_i),
-        .reset(flush_w),
-        .d(reg_write_m),
-        .q(reg_write_w)
-    );
-
-    flopr #(.WIDTH(2))
-    flopr_result_src_w(
-        .clk(clk_i),
-        .reset(flush_w),
-        .d(result_src_m),
-        .q(result_src_w)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_alu_result_w(
-        .clk(clk_i),
-        .reset(flush_w),
-        .d(alu_result_m),
-        .q(alu_result_w)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_read_data_w(
-        .clk(clk_i),
-        .reset(flush_w),
-        .d(read_data_m),
-        .q(read_data_w)
-    );
-
-    flopr #(.WIDTH(`REG_ADDR_WIDTH))
-    flopr_rd_w(
-        .clk(clk_i),
-        .reset(flush_w),
-        .d(rd_m),
-        .q(rd_w)
-    );
-
-    flopr #(.WIDTH(`DATA_WIDTH))
-    flopr_pc_4_w(
-        .clk(clk_i),
-        .reset(flush_w),
-        .d(pc_4_m),
-        .q(pc_4_w)
-    );
+    logic halt_w;
+    logic fused_w;
+    assign reg_write_w = mem_wb.reg_write;
+    assign result_src_w = mem_wb.result_src;
+    assign alu_result_w = mem_wb.alu_result;
+    assign read_data_w = mem_wb.read_data;
+    assign rd_w = mem_wb.rd;
+    assign pc_4_w = mem_wb.pc_4;
+    assign halt_w = mem_wb.halt;
+    assign fused_w = mem_wb.fused;
 
     // Writeback Stage
 
     logic [`DATA_WIDTH-1:0] result_w;
     assign wd3_d = result_w;
-    assign we3_d = reg_write_w;
+    // A held Writeback writes the register file once, when it moves on
+    assign we3_d = reg_write_w && !stall_w;
     assign wa3_d = rd_w;
+    // PC of the instruction in Writeback, for commit tracing in the harness
+    assign pc_w_o = pc_4_w - (fused_w ? 8 : 4);
+    // Stores are never fused or paired, so the one in Memory sits at pc_4 - 4
+    assign mem_we_m_o = mem_write_m && !stall_m;
+    assign mem_adr_m_o = alu_result_m;
+    assign mem_wd_m_o = write_data_m;
+    assign pc_m_o = pc_4_m - 4;
+    assign fused_w_o = fused_w;
+    assign halt_o = halt_w;
+    // The second slot holds the instruction after the first one
+    assign wd6_d_o = wd6_d;
+    assign we6_d_o = we6_d;
+    assign wa6_d_o = wa6_d;
+    assign pc_w2_o = pc_4_w;
 
     mux3 #(.WIDTH(`DATA_WIDTH))
     mux3_result_w(
@@ -531,15 +932,73 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
 
     logic [`DATA_WIDTH-1:0] pc_f_prev_calc;
 
+    logic [`DATA_WIDTH-1:0] pc_next_predicted_f;
+
+    generate
+        if (BRANCH_PREDICTOR != 0) begin : g_branch_predictor
+            branch_predictor #(
+                .GSHARE(BRANCH_PREDICTOR == 2),
+                .BHT_BITS(BHT_BITS),
+                .BTB_BITS(BTB_BITS),
+                .RAS_BITS(RAS_BITS)
+            ) branch_predictor_inst(
+                .clk_i(clk_i),
+                .rst_i(rst_i),
+                .pc_f_i(pc_f_new),
+                .taken_f_o(pred_taken_f),
+                .target_f_o(pred_target_f),
+                .update_e_i((branch_e || jump_e) && !stall_m),
+                .branch_e_i(branch_e),
+                .call_e_i(call_e),
+                .return_e_i(return_e),
+                .taken_e_i(pc_src_e),
+                .pc_e_i(pc_e),
+                .pc_4_e_i(pc_4_e),
+                .target_e_i(pc_target_e)
+            );
+        end else begin : g_no_branch_predictor
+            assign pred_taken_f = 1'b0;
+            assign pred_target_f = '0;
+        end
+    endgenerate
+
+    logic [`DATA_WIDTH-1:0] pc_next_seq_f;
+
     mux2 #(.WIDTH(`DATA_WIDTH))
-    mux2_pc_w(
+    mux2_pc_seq_f(
         .data0_i(pc_4_f),
-        .data1_i(pc_target_e),
-        .sel_i(pc_src_e),
+        .data1_i(pc_8_f),
+        .sel_i(pair_f || fused_f),
+        .data_o(pc_next_seq_f)
+    );
+
+    mux2 #(.WIDTH(`DATA_WIDTH))
+    mux2_pc_predicted_f(
+        .data0_i(pc_next_seq_f),
+        .data1_i(pred_target_f),
+        .sel_i(pred_taken_f),
+        .data_o(pc_next_predicted_f)
+    );
+
+    // At most one of the two redirects exists in a build (EARLY_BRANCH)
+    assign redirect_f = redirect_e || redirect_d;
+    assign redirect_pc_f = redirect_d ? redirect_pc_d : redirect_pc_e;
+
+    mux2 #(.WIDTH(`DATA_WIDTH))
+    mux2_pc_w(
+        .data0_i(pc_next_predicted_f),
+        .data1_i(redirect_pc_f),
+        .sel_i(redirect_f),
         .data_o(pc_f_prev_calc)
     );
 
-    assign pc_f_prev = rst_i ? PC_START_ADDR - 4 : pc_f_prev_calc;
+    // Reset points Fetch at pc_start_i while IF/ID holds a bubble: the first
+    // instruction to reach Decode is the one at pc_start_i, never the word
+    // before it (a real instruction once the harness injects a mid-program state)
+    assign pc_f_prev = rst_i ? pc_start_i : pc_f_prev_calc;
+
+    logic load_use_stall_d;
+    logic branch_stall_d;
 
     hazard_unit hazard_unit_inst(
         .Rs1E(rs1_e),
@@ -550,20 +1009,274 @@ module pipeline #(parameter string INSTR_MEM_INIT_FILE = "", parameter string DA
         .RdM(rd_m),
         .RdW(rd_w),
 
+        .RegWriteE(reg_write_e),
         .RegWriteM(reg_write_m),
         .RegWriteW(reg_write_w),
 
+        .Rs1E2(rs1_e2),
+        .Rs2E2(rs2_e2),
+        .Rs1D2(rs1_d2),
+        .Rs2D2(rs2_d2),
+        .RdE2(rd_e2),
+        .RdM2(rd_m2),
+        .RdW2(rd_w2),
+
+        .RegWriteE2(reg_write_e2),
+        .RegWriteM2(reg_write_m2),
+        .RegWriteW2(reg_write_w2),
+
         .ResultSrcE0(result_src_e[0]),
-        .PCSrcE(pc_src_e),
+        .ResultSrcM0(result_src_m[0]),
+        .BranchD(branch_operands_d),
+        .PCSrcD(redirect_d),
+        .PCSrcE(redirect_e),
+        .IStallF(icache_stall_f),
+        .DStallM(dcache_stall_m),
+        .DivStallE(div_busy_e),
 
         .ForwardAE(forward_a_e),
         .ForwardBE(forward_b_e),
+        .ForwardAE2(forward_a_e2),
+        .ForwardBE2(forward_b_e2),
+        .ForwardSlotAE(forward_slot_a_e),
+        .ForwardSlotBE(forward_slot_b_e),
+        .ForwardSlotAE2(forward_slot_a_e2),
+        .ForwardSlotBE2(forward_slot_b_e2),
+        .ForwardAD(forward_a_d),
+        .ForwardBD(forward_b_d),
 
         .StallF(stall_f),
         .StallD(stall_d),
+        .StallE(stall_e),
+        .StallM(stall_m),
+        .StallW(stall_w),
         .FlushD(flush_d),
-        .FlushE(flush_e)
+        .FlushE(flush_e),
+        .FlushM(flush_m),
+
+        .LoadUseStallD(load_use_stall_d),
+        .BranchStallD(branch_stall_d)
+    );
+
+    assign stall_o = {stall_w, stall_m, stall_e, stall_d, stall_f};
+    assign flush_o = {flush_m, flush_e, flush_d};
+    assign redirect_o = redirect_f;
+
+    // pc_4 != 0 is the valid bit: flushed or stalled slots reach Writeback with
+    // pc_4 cleared, and so do the slots reset leaves behind, Decode included
+    perf_counters perf_counters_inst(
+        .clk_i(clk_i),
+        .rst_i(rst_i),
+        .freeze_i(stall_w),
+        .retire_w_i(pc_4_w != '0),
+        .retire_w2_i(reg_write_w2),
+        .fused_w_i(fused_w),
+        .load_use_stall_i(load_use_stall_d && !stall_e),
+        .branch_stall_i(branch_stall_d && !stall_e),
+        .branch_i(branch_e),
+        .jump_i(jump_e),
+        .branch_flush_i((redirect_e && branch_e) || (redirect_d && branch_d)),
+        .jump_flush_i((redirect_e && jump_e) || (redirect_d && jump_d)),
+        .forward_a_i(forward_a_e),
+        .forward_b_i(forward_b_e),
+        .icache_hit_i(icache_hit),
+        .icache_miss_i(icache_miss),
+        .icache_evict_i(icache_evict),
+        .icache_stall_i(icache_stall_f),
+        .dcache_hit_i(dcache_hit),
+        .dcache_miss_i(dcache_miss),
+        .dcache_evict_i(dcache_evict),
+        .dcache_stall_i(dcache_stall_m),
+        .muldiv_i(muldiv_e && !stall_e),
+        .div_stall_i(div_busy_e)
     );
 
+    // Second issue slot: Decode, an ALU in Execute and the result registers
+    // through Writeback. Each of its registers shares the enable and reset of
+    // the first slot's register at the same boundary, so the pair moves,
+    // waits and is flushed as one; hazard_unit forwards from either slot.
+    generate
+        if (DUAL_ISSUE != 0) begin : g_dual_issue
+            // Register between Fetch and Decode
+
+            if_id2_t if_id2_next;
+            if_id2_t if_id2;
+
+            assign if_id2_next.instr = pair_f ? instr2_f : '0;
+            assign if_id2_next.valid = pair_f;
+
+            flopenr #($bits(if_id2_t))
+            flopenr_if_id2(
+                .clk(clk_i),
+                .reset(flush_d || rst_i),
+                .en(!stall_d),
+                .d(if_id2_next),
+                .q(if_id2)
+            );
+
+            // Decode Stage
+
+            logic [`INSTR_WIDTH-1:0] instr_d2;
+            assign instr_d2 = if_id2.instr;
+            assign rs1_d2 = instr_d2[19:15];
+            assign rs2_d2 = instr_d2[24:20];
+
+            logic [3:0] alu_control_d2;
+            logic alu_src_d2;
+            logic [1:0] imm_src_d2;
+            logic [`INSTR_WIDTH-1:0] imm_d2_32;
+
+            control_unit cu2(
+                .op_i(instr_d2[6:0]),
+                .funct3_i(instr_d2[14:12]),
+                .funct7_5_i(instr_d2[30]),
+                .funct7_0_i(instr_d2[25]),
+
+                .RegWriteD_o(),
+                .ResultSrcD_o(),
+                .MemWriteD_o(),
+                .JumpD_o(),
+                .BranchD_o(),
+                .ALUSrcD_o(alu_src_d2),
+                .ImmSelD_o(imm_src_d2),
+                .Is_U_typeD_o(),
+                .ALUControlD_o(alu_control_d2[2:0]),
+                .ALUModifierD_o(alu_control_d2[3]),
+                .MulDivD_o(),
+                .MulDivOpD_o()
+            );
+
+            imm imm_gen2(
+                .instr(instr_d2[`INSTR_WIDTH-1:7]),
+                .immsrc(imm_src_d2),
+                .immext(imm_d2_32)
+            );
+
+            // Register between Decode and Execute
+
+            id_ex2_t id_ex2_next;
+            id_ex2_t id_ex2;
+
+            assign id_ex2_next.imm = {{(`DATA_WIDTH-`INSTR_WIDTH){imm_d2_32[31]}}, imm_d2_32};
+            assign id_ex2_next.rd1 = rs1_val_d2;
+            assign id_ex2_next.rd2 = rs2_val_d2;
+            assign id_ex2_next.rs1 = rs1_d2;
+            assign id_ex2_next.rs2 = rs2_d2;
+            assign id_ex2_next.rd = instr_d2[11:7];
+            assign id_ex2_next.alu_control = alu_control_d2;
+            assign id_ex2_next.alu_src = alu_src_d2;
+            assign id_ex2_next.valid = if_id2.valid;
+
+            flopenr #($bits(id_ex2_t))
+            flopenr_id_ex2(
+                .clk(clk_i),
+                .reset(flush_e || rst_i),
+                .en(!stall_e),
+                .d(id_ex2_next),
+                .q(id_ex2)
+            );
+
+            assign rs1_e2 = id_ex2.rs1;
+            assign rs2_e2 = id_ex2.rs2;
+            assign rd_e2 = id_ex2.rd;
+            assign reg_write_e2 = id_ex2.valid;
+
+            // Execute Stage
+
+            logic [`DATA_WIDTH-1:0] alu_operand_a_e2;
+            logic [`DATA_WIDTH-1:0] alu_operand_b_reg2;
+            logic [`DATA_WIDTH-1:0] alu_result_e2;
+
+            mux3 #(.WIDTH(`DATA_WIDTH))
+            mux3_alu_operand_a_e2(
+                .data0_i(id_ex2.rd1),
+                .data1_i(forward_slot_a_e2 ? wd6_d : wd3_d),
+                .data2_i(forward_slot_a_e2 ? alu_result_m2 : alu_result_m),
+                .sel_i(forward_a_e2),
+                .data_o(alu_operand_a_e2)
+            );
+
+            mux3 #(.WIDTH(`DATA_WIDTH))
+            mux3_alu_operand_b_e2(
+                .data0_i(id_ex2.rd2),
+                .data1_i(forward_slot_b_e2 ? wd6_d : wd3_d),
+                .data2_i(forward_slot_b_e2 ? alu_result_m2 : alu_result_m),
+                .sel_i(forward_b_e2),
+                .data_o(alu_operand_b_reg2)
+            );
+
+            alu alu2(
+                .operand_a(alu_operand_a_e2),
+                .operand_b(id_ex2.alu_src ? id_ex2.imm : alu_operand_b_reg2),
+                .alu_op_select(id_ex2.alu_control[2:0]),
+                .alu_modifier(id_ex2.alu_control[3]),
+                .result(alu_result_e2),
+                .zero_flag()
+            );
+
+            // Register between Execute and Memory
+
+            ex_mem2_t ex_mem2_next;
+            ex_mem2_t ex_mem2;
+
+            assign ex_mem2_next.alu_result = alu_result_e2;
+            assign ex_mem2_next.rd = id_ex2.rd;
+            assign ex_mem2_next.valid = id_ex2.valid;
+
+            flopenr #($bits(ex_mem2_t))
+            flopenr_ex_mem2(
+                .clk(clk_i),
+                .reset(flush_m || rst_i),
+                .en(!stall_m),
+                .d(ex_mem2_next),
+                .q(ex_mem2)
+            );
+
+            assign alu_result_m2 = ex_mem2.alu_result;
+            assign rd_m2 = ex_mem2.rd;
+            assign reg_write_m2 = ex_mem2.valid;
+
+            // Register between Memory and Writeback
+
+            mem_wb2_t mem_wb2_next;
+            mem_wb2_t mem_wb2;
+
+            assign mem_wb2_next.alu_result = alu_result_m2;
+            assign mem_wb2_next.rd = rd_m2;
+            assign mem_wb2_next.valid = reg_write_m2;
+
+            flopenr #($bits(mem_wb2_t))
+            flopenr_mem_wb2(
+                .clk(clk_i),
+                .reset(flush_w || rst_i),
+                .en(!stall_w),
+                .d(mem_wb2_next),
+                .q(mem_wb2)
+            );
+
+            // Writeback Stage: register file port 6
+
+            assign rd_w2 = mem_wb2.rd;
+            assign reg_write_w2 = mem_wb2.valid;
+            assign wd6_d = mem_wb2.alu_result;
+            assign we6_d = reg_write_w2 && !stall_w;
+            assign wa6_d = rd_w2;
+        end else begin : g_single_issue
+            assign rs1_d2 = '0;
+            assign rs2_d2 = '0;
+            assign rs1_e2 = '0;
+            assign rs2_e2 = '0;
+            assign rd_e2 = '0;
+            assign reg_write_e2 = 1'b0;
+            assign rd_m2 = '0;
+            assign reg_write_m2 = 1'b0;
+            assign alu_result_m2 = '0;
+            assign rd_w2 = '0;
+            assign reg_write_w2 = 1'b0;
+            assign wd6_d = '0;
+            assign we6_d = 1'b0;
+            assign wa6_d = '0;
+        end
+    endgenerate
 
 endmodule
\ No newline at end of file
@@ -1,23 +1,106 @@
 `include "common/defines.svh"
 
-module ram #(parameter N = 10, M = `DATA_WIDTH, OFFSET_BITS = (M==32) ? 2 : 3, ADR_WIDTH = `DATA_WIDTH, parameter string INIT_FILE = "")
+// READ_PORT2 = 1 adds a second combinational read port (adr2/dout2) over the same
+// words, e.g. for fetching two instructions per cycle; otherwise dout2 is zero.
+module ram #(parameter N = 10, M = `DATA_WIDTH, OFFSET_BITS = (M==32) ? 2 : 3, ADR_WIDTH = `DATA_WIDTH, parameter string INIT_FILE = "",
+             parameter string INIT_PLUSARG = "", parameter SPARSE = 0, parameter READ_PORT2 = 0)
             (input  logic         clk,
             input  logic         we,
             input  logic [ADR_WIDTH-1:0] adr,
             input  logic [M-1:0] din,
-            output logic [M-1:0] dout);
+            output logic [M-1:0] dout,
+            input  logic [ADR_WIDTH-1:0] adr2,
+            output logic [M-1:0] dout2);
 
   localparam MEM_DEPTH = 2**(N - OFFSET_BITS);
 
-  logic [M-1:0] mem [2**(N-OFFSET_BITS)-1:0];
-  always_ff @(posedge clk)
-    if (we) mem [adr[N - 1 : OFFSET_BITS]] <= din;
-  assign dout = mem[adr[N - 1 : OFFSET_BITS]];
+  // SPARSE = 1 keeps the words in a page-granular C++ store (tests/harness/sparse_memory.cpp):
+  // pages are allocated on first write and untouched pages read as zero, so the
+  // 2**N-byte array is neither allocated nor zero-filled. The flat array shrinks to one word.
+  localparam FLAT_DEPTH = SPARSE ? 1 : MEM_DEPTH;
+
+  import "DPI-C" function chandle sparse_mem_create(input int word_bytes);
+  import "DPI-C" function void sparse_mem_destroy(input chandle mem_h);
+  import "DPI-C" function int sparse_mem_load_hex(input chandle mem_h, input string file_name);
+  import "DPI-C" function void sparse_mem_write(input chandle mem_h, input longint unsigned word_adr,
+                                                input longint unsigned data);
+  // write_gen is unused on the C++ side; it only makes the combinational read
+  // re-evaluate after a write to the address currently on adr.
+  import "DPI-C" function longint unsigned sparse_mem_read(input chandle mem_h, input longint unsigned word_adr,
+                                                           input int write_gen);
+
+  logic [M-1:0] mem [FLAT_DEPTH-1:0];
+  chandle sparse_mem_h;
+  int write_gen = 0;
+  int dpi_write_gen = 0;
+
+  generate
+    if (SPARSE) begin : g_sparse
+      always_ff @(posedge clk)
+        if (we) begin
+          sparse_mem_write(sparse_mem_h, 64'(adr[N - 1 : OFFSET_BITS]), 64'(din));
+          write_gen <= write_gen + 1;
+        end
+      assign dout = M'(sparse_mem_read(sparse_mem_h, 64'(adr[N - 1 : OFFSET_BITS]), write_gen + dpi_write_gen));
+    end else begin : g_flat
+      always_ff @(posedge clk)
+        if (we) mem [adr[N - 1 : OFFSET_BITS]] <= din;
+      assign dout = mem[adr[N - 1 : OFFSET_BITS]];
+    end
+
+    if (READ_PORT2 == 0) begin : g_no_port2
+      assign dout2 = '0;
+    end else if (SPARSE) begin : g_sparse_port2
+      assign dout2 = M'(sparse_mem_read(sparse_mem_h, 64'(adr2[N - 1 : OFFSET_BITS]), write_gen + dpi_write_gen));
+    end else begin : g_flat_port2
+      assign dout2 = mem[adr2[N - 1 : OFFSET_BITS]];
+    end
+  endgenerate
+
+  // Backdoor access for the C++ harness (ELF loader etc.). The caller selects the
+  // instance with svSetScope(); addresses are byte addresses, decoded like adr.
+  export "DPI-C" function ram_dpi_read;
+  export "DPI-C" function ram_dpi_write;
+  export "DPI-C" function ram_dpi_word_bytes;
+
+  function longint unsigned ram_dpi_read(input longint unsigned byte_adr);
+      if (SPARSE)
+          return sparse_mem_read(sparse_mem_h, 64'(byte_adr[N - 1 : OFFSET_BITS]), 0);
+      return 64'(mem[byte_adr[N - 1 : OFFSET_BITS]]);
+  endfunction
+
+  function void ram_dpi_write(input longint unsigned byte_adr, input longint unsigned data);
+      if (SPARSE) begin
+          sparse_mem_write(sparse_mem_h, 64'(byte_adr[N - 1 : OFFSET_BITS]), 64'(data[M - 1 : 0]));
+          dpi_write_gen = dpi_write_gen + 1;
+      end else begin
+          mem[byte_adr[N - 1 : OFFSET_BITS]] = data[M - 1 : 0];
+      end
+  endfunction
+
+  function int ram_dpi_word_bytes();
+      return M / 8;
+  endfunction
+
+  // INIT_PLUSARG lets the testbench pick the image at runtime (+<INIT_PLUSARG>=<file>),
+  // so one verilated model serves every program instead of re-verilating per INIT_FILE.
+  string init_file;
 
   initial begin
-      if (INIT_FILE != "") begin
-          $display("RAM module %m (instance path) initializing from file: %s", $sformatf("%m"), INIT_FILE);
-          $readmemh(INIT_FILE, mem);
+      init_file = INIT_FILE;
+      if (INIT_PLUSARG != "") begin
+          void'($value$plusargs({INIT_PLUSARG, "=%s"}, init_file));
+      end
+      if (SPARSE) begin
+          sparse_mem_h = sparse_mem_create(M / 8);
+          if (init_file != "") begin
+              $display("RAM module %m (sparse) initializing from file: %s", init_file);
+              if (sparse_mem_load_hex(sparse_mem_h, init_file) == 0)
+                  $display("RAM module %m: failed to load %s", init_file);
+          end
+      end else if (init_file != "") begin
+          $display("RAM module %m (instance path) initializing from file: %s", $sformatf("%m"), init_file);
+          $readmemh(init_file, mem);
       end else begin
           for (int i = 0; i < MEM_DEPTH; i++) begin
               mem[i] = {M{1'b0}};
@@ -26,5 +109,9 @@ module ram #(parameter N = 10, M = `DATA_WIDTH, OFFSET_BITS = (M==32) ? 2 : 3, A
       end
   end
 
+  final begin
+      if (SPARSE) sparse_mem_destroy(sparse_mem_h);
+  end
+
 
 endmodule
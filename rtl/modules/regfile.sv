@@ -1,6 +1,14 @@
 `include "common/defines.svh"
 
-module regfile (
+// POSEDGE_BYPASS = 0: the pipeline clocks the file with an inverted clock, so a
+// Writeback write lands mid-cycle and Decode reads it in the same cycle.
+// POSEDGE_BYPASS = 1: the file shares the pipeline clock and a write in flight
+// is forwarded straight to the read ports instead. Architectural results are
+// the same, and the model no longer has any negedge logic to evaluate.
+// Ports 4-6 (two reads, one write) serve the second issue slot of a DUAL_ISSUE
+// pipeline and are tied off otherwise. Port 6 belongs to the younger
+// instruction, so it wins when both write ports target the same register.
+module regfile #(parameter POSEDGE_BYPASS = 0) (
     input  logic        clk,
     input  logic        we3,
     input  logic [`REG_ADDR_WIDTH-1:0]  a1,
@@ -8,7 +16,15 @@ module regfile (
     input  logic [`REG_ADDR_WIDTH-1:0]  a3,
     input  logic [`DATA_WIDTH-1:0] wd3,
     output logic [`DATA_WIDTH-1:0] rd1,
-    output logic [`DATA_WIDTH-1:0] rd2
+    output logic [`DATA_WIDTH-1:0] rd2,
+
+    input  logic        we6,
+    input  logic [`REG_ADDR_WIDTH-1:0]  a4,
+    input  logic [`REG_ADDR_WIDTH-1:0]  a5,
+    input  logic [`REG_ADDR_WIDTH-1:0]  a6,
+    input  logic [`DATA_WIDTH-1:0] wd6,
+    output logic [`DATA_WIDTH-1:0] rd4,
+    output logic [`DATA_WIDTH-1:0] rd5
 );
 
     logic [63:0] rf[31:0];
@@ -19,12 +35,27 @@ module regfile (
         if (we3 && (a3 != 5'b0)) begin
             rf[a3] <= wd3;
         end
+        if (we6 && (a6 != 5'b0)) begin
+            rf[a6] <= wd6;
+        end
     end
 
 
 
-    assign rd1 = (a1 == `REG_ADDR_WIDTH'b0) ? `DATA_WIDTH'b0 : rf[a1];
-    assign rd2 = (a2 == `REG_ADDR_WIDTH'b0) ? `DATA_WIDTH'b0 : rf[a2];
+    function automatic logic [`DATA_WIDTH-1:0] read_port(input logic [`REG_ADDR_WIDTH-1:0] a);
+        if (a == `REG_ADDR_WIDTH'b0)
+            return `DATA_WIDTH'b0;
+        if (POSEDGE_BYPASS && we6 && a6 == a)
+            return wd6;
+        if (POSEDGE_BYPASS && we3 && a3 == a)
+            return wd3;
+        return rf[a];
+    endfunction
+
+    assign rd1 = read_port(a1);
+    assign rd2 = read_port(a2);
+    assign rd4 = read_port(a4);
+    assign rd5 = read_port(a5);
 
 
     initial begin
@@ -33,4 +64,18 @@ module regfile (
         end
     end
 
+    // Backdoor access for the C++ harness (architectural state injection after
+    // fast-forward). The caller selects the instance with svSetScope().
+    export "DPI-C" function regfile_dpi_read;
+    export "DPI-C" function regfile_dpi_write;
+
+    function longint unsigned regfile_dpi_read(input int index);
+        return (index == 0) ? 64'b0 : 64'(rf[index[`REG_ADDR_WIDTH-1:0]]);
+    endfunction
+
+    function void regfile_dpi_write(input int index, input longint unsigned data);
+        if (index != 0)
+            rf[index[`REG_ADDR_WIDTH-1:0]] = data[`DATA_WIDTH-1:0];
+    endfunction
+
 endmodule
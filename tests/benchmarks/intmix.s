@@ -0,0 +1,39 @@
+# Dhrystone-style integer mix: xorshift64 generator, shifts, logic, compares
+# and read-modify-write of a small record in memory.
+.section .text
+.global _start
+
+_start:
+    addi x5, x0, 1          # generator state
+    addi x10, x0, 1
+    slli x10, x10, 12       # record at 0x1000
+    addi x20, x0, 0
+    addi x21, x0, 1000
+loop:
+    slli x6, x5, 13
+    xor  x5, x5, x6
+    srli x6, x5, 7
+    xor  x5, x5, x6
+    slli x6, x5, 17
+    xor  x5, x5, x6
+    ld   x7, 0(x10)
+    add  x7, x7, x5
+    sd   x7, 0(x10)
+    andi x8, x5, 255
+    ld   x9, 8(x10)
+    sub  x9, x9, x8
+    sd   x9, 8(x10)
+    or   x12, x7, x9
+    and  x13, x12, x5
+    sd   x13, 16(x10)
+    sltu x14, x7, x9
+    beq  x14, x0, skip
+    addi x15, x15, 1
+    sd   x15, 24(x10)
+skip:
+    addi x20, x20, 1
+    beq  x20, x21, wrap
+    jal  x0, loop
+wrap:
+    addi x20, x0, 0
+    jal  x0, loop
@@ -0,0 +1,15 @@
+# Tight counted loop: ALU + forwarding + taken branch/jump on every iteration.
+# Only beq/jal are used for control flow.
+.section .text
+.global _start
+
+_start:
+    addi x6, x0, 1000
+outer:
+    addi x5, x0, 0
+inner:
+    addi x5, x5, 1
+    add  x7, x7, x5
+    xor  x8, x8, x7
+    beq  x5, x6, outer
+    jal  x0, inner
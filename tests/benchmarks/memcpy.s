@@ -0,0 +1,31 @@
+# memcpy of 256 doublewords from 0x1000 to 0x2000, repeated forever.
+# The source is filled once with an arithmetic sequence.
+.section .text
+.global _start
+
+_start:
+    addi x10, x0, 1
+    slli x10, x10, 12       # src = 0x1000
+    slli x11, x10, 1        # dst = 0x2000
+    addi x13, x10, 1024
+    addi x13, x13, 1024     # src end = src + 256 * 8
+    addi x12, x10, 0
+    addi x14, x0, 7
+init:
+    sd   x14, 0(x12)
+    addi x14, x14, 3
+    addi x12, x12, 8
+    beq  x12, x13, copy_start
+    jal  x0, init
+copy_start:
+    addi x12, x10, 0
+    addi x15, x11, 0
+copy:
+    ld   x16, 0(x12)
+    ld   x17, 8(x12)
+    sd   x16, 0(x15)
+    sd   x17, 8(x15)
+    addi x12, x12, 16
+    addi x15, x15, 16
+    beq  x12, x13, copy_start
+    jal  x0, copy
@@ -0,0 +1,99 @@
+// Замер скорости моделирования Vpipeline: такты/с и выполненные инструкции/с на длинном ядре.
+// Имя прогона передаётся как --name <ядро>@<вариант сборки>; строка результата
+// дописывается в CSV из --output (заголовок -- если файл пуст).
+#include "pipeline_harness.h"
+#include "sim_options.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <sys/resource.h>
+
+// Пиковый RSS процесса в КиБ (ru_maxrss в Linux уже в КиБ)
+static long peak_rss_kib() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+static const char* trace_format_name(TraceFormat format) {
+    switch (format) {
+        case TraceFormat::Vcd: return "vcd";
+        case TraceFormat::Fst: return "fst";
+        case TraceFormat::Off: return "off";
+    }
+    return "off";
+}
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    SimOptions opts;
+    if (!parse_sim_options(argc, argv, opts) || opts.num_cycles == 0) {
+        print_sim_options_usage(argv[0]);
+        return 1;
+    }
+
+    std::string kernel = opts.test_name;
+    std::string variant = "default";
+    size_t at = opts.test_name.find('@');
+    if (at != std::string::npos) {
+        kernel = opts.test_name.substr(0, at);
+        variant = opts.test_name.substr(at + 1);
+    }
+
+    PipelineHarness harness(opts);
+    if (!harness.load_program()) {
+        return 1;
+    }
+    if (!harness.open_trace(kernel + "_" + variant + "_bench")) {
+        return 1;
+    }
+    if (!harness.start()) {
+        return 1;
+    }
+
+    // Замеряется только цикл тактов: загрузка программы и сброс не входят
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t cycle = 0; cycle < opts.num_cycles; ++cycle) {
+        harness.tick();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    PerfSnapshot perf;
+    if (!harness.read_perf(perf)) {
+        return 1;
+    }
+    const uint64_t retired = perf[PERF_INSTRET];
+
+    double cycles_per_sec = opts.num_cycles / seconds;
+    double instr_per_sec = retired / seconds;
+    long rss_kib = peak_rss_kib();
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "BENCH " << kernel << " [" << variant << ", trace " << trace_format_name(opts.trace.format) << "]: "
+              << opts.num_cycles << " cycles, " << retired << " instr in " << std::setprecision(3) << seconds
+              << " s -> " << std::setprecision(0) << cycles_per_sec << " cycles/s, " << instr_per_sec
+              << " instr/s, IPC " << std::setprecision(3) << static_cast<double>(retired) / opts.num_cycles
+              << ", peak RSS " << rss_kib << " KiB" << std::endl;
+
+    if (!opts.output_file.empty()) {
+        std::ofstream csv(opts.output_file, std::ios::app);
+        if (!csv.is_open()) {
+            std::cerr << "ERROR: Could not open benchmark CSV: " << opts.output_file << std::endl;
+            return 1;
+        }
+        if (csv.tellp() == 0) {
+            csv << "kernel,variant,trace,cycles,instret,seconds,cycles_per_sec,instr_per_sec,peak_rss_kib\n";
+        }
+        csv << kernel << "," << variant << "," << trace_format_name(opts.trace.format) << ","
+            << opts.num_cycles << "," << retired << "," << std::setprecision(6) << seconds << ","
+            << std::setprecision(0) << cycles_per_sec << "," << instr_per_sec << "," << rss_kib << "\n";
+    }
+    return 0;
+}
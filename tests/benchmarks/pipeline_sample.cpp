@@ -0,0 +1,143 @@
+// Выборочное моделирование Vpipeline в духе SMARTS: длинные интервалы выполняет RefHart,
+// короткие окна -- RTL. Перед каждым окном архитектурное состояние RefHart переносится
+// в модель (PipelineHarness::load_arch_state), --sample-warmup инструкций заполняют
+// конвейер, а приращения perf_counters за следующие --sample-window инструкций дают одно
+// измерение. Функциональный прогрев сводится к архитектурному состоянию: предсказатель
+// переходов и кэши (PIPELINE_BRANCH_PREDICTOR, PIPELINE_ICACHE/DCACHE) сбрасываются вместе
+// с моделью и прогреваются теми же --sample-warmup инструкциями, так что с кэшами прогрев
+// стоит увеличить. Строка результата дописывается в CSV из --output.
+#include "pipeline_harness.h"
+#include "ref_hart.h"
+#include "sampling.h"
+#include "sim_options.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Выполняет count инструкций на эталоне; false -- программа закончилась раньше
+static bool advance(RefHart& ref, uint64_t count) {
+    return ref.run(count) == RefHart::StepResult::Ok;
+}
+
+// Такты до instret >= target; false -- останов программы или сторожевой предел
+static bool run_until_instret(PipelineHarness& harness, uint64_t target, uint64_t max_cycles) {
+    while (harness.perf_counter(PERF_INSTRET) < target) {
+        if (harness.halted() || harness.cycle() >= max_cycles) {
+            return false;
+        }
+        harness.tick();
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    SimOptions opts;
+    if (!parse_sim_options(argc, argv, opts) || opts.elf_file.empty() || opts.sampling.samples == 0 ||
+        opts.sampling.window == 0) {
+        std::cerr << "ERROR: Sampling needs --elf, --samples and a non-zero --sample-window." << std::endl;
+        print_sim_options_usage(argv[0]);
+        return 1;
+    }
+    const SamplingOptions& sampling = opts.sampling;
+    // Сторожевой предел тактов на окно вместе с прогревом: --max-cycles, иначе CPI 100
+    const uint64_t window_cycle_limit = opts.max_cycles ? opts.max_cycles : (sampling.warmup + sampling.window) * 100;
+
+    std::string kernel = opts.test_name;
+    std::string variant = "sampled";
+    size_t at = opts.test_name.find('@');
+    if (at != std::string::npos) {
+        kernel = opts.test_name.substr(0, at);
+        variant = opts.test_name.substr(at + 1);
+    }
+
+    PipelineHarness harness(opts);
+    if (!harness.load_program()) {
+        return 1;
+    }
+
+    RefHart ref;
+    ref.load(harness.program_image());
+    ref.set_pc(harness.top()->pc_start_i);
+
+    SampledPerf estimate;
+    uint64_t detailed_cycles = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t sample = 0; sample < sampling.samples; ++sample) {
+        if (!advance(ref, sampling.interval)) {
+            std::cout << "SAMPLE: program ended during functional warming before window " << sample << std::endl;
+            break;
+        }
+        if (!harness.load_arch_state(ref)) {
+            return 1;
+        }
+        // Окно считает только инструкции с ref.pc(): выборка начинается с него, а конвейер
+        // и счётчики после сброса пусты
+        if (harness.top()->pc_f_o != ref.pc() || harness.perf_counter(PERF_INSTRET) != 0) {
+            std::cerr << "ERROR: Window " << sample << " does not start at pc 0x" << std::hex << ref.pc()
+                      << " (fetch at 0x" << harness.top()->pc_f_o << std::dec << ", INSTRET "
+                      << harness.perf_counter(PERF_INSTRET) << ")." << std::endl;
+            return 1;
+        }
+
+        PerfSnapshot before;
+        PerfSnapshot after;
+        if (!run_until_instret(harness, sampling.warmup, window_cycle_limit) || !harness.read_perf(before) ||
+            !run_until_instret(harness, sampling.warmup + sampling.window, window_cycle_limit) ||
+            !harness.read_perf(after)) {
+            std::cout << "SAMPLE: window " << sample << " at pc 0x" << std::hex << ref.pc() << std::dec
+                      << " did not complete (halt or " << window_cycle_limit << "-cycle limit)" << std::endl;
+            break;
+        }
+        estimate.add_window(after - before);
+        detailed_cycles += harness.cycle();
+
+        // RTL выполнил те же инструкции, что и эталон, начиная с ref.pc(): эталон догоняет
+        // его к следующему интервалу
+        if (!advance(ref, after[PERF_INSTRET])) {
+            break;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (estimate.windows() == 0) {
+        std::cerr << "ERROR: No sample windows were measured." << std::endl;
+        return 1;
+    }
+
+    const uint64_t total_instr = ref.instret();
+    const uint64_t detailed_instr = estimate.windows() * (sampling.warmup + sampling.window);
+    std::cout << std::fixed << std::setprecision(3)
+              << "SAMPLE " << kernel << " [" << variant << "]: " << total_instr << " instr, "
+              << detailed_instr << " in detail (" << std::setprecision(2)
+              << 100.0 * detailed_instr / total_instr << "%), " << detailed_cycles << " RTL cycles, "
+              << std::setprecision(3) << seconds << " s" << std::defaultfloat << std::endl;
+    estimate.print(std::cout);
+
+    if (!opts.output_file.empty()) {
+        std::ofstream csv(opts.output_file, std::ios::app);
+        if (!csv.is_open()) {
+            std::cerr << "ERROR: Could not open sampling CSV: " << opts.output_file << std::endl;
+            return 1;
+        }
+        if (csv.tellp() == 0) {
+            csv << "kernel,variant,windows,total_instr,detailed_instr,seconds";
+            for (unsigned i = 0; i < SAMPLE_NUM_METRICS; ++i) {
+                csv << "," << sample_metric_name(i) << "," << sample_metric_name(i) << "_ci95";
+            }
+            csv << "\n";
+        }
+        csv << kernel << "," << variant << "," << estimate.windows() << "," << total_instr << ","
+            << detailed_instr << "," << std::setprecision(6) << seconds;
+        for (unsigned i = 0; i < SAMPLE_NUM_METRICS; ++i) {
+            const SampleEstimate& m = estimate.metric(i);
+            csv << "," << m.mean() << "," << m.half_width(SAMPLE_Z_95);
+        }
+        csv << "\n";
+    }
+    return 0;
+}
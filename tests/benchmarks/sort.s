@@ -0,0 +1,37 @@
+# Bubble sort of 64 doublewords filled in descending order; refilled and re-sorted forever.
+# Data-dependent branches, load-use hazards and stores on every swap.
+.section .text
+.global _start
+
+_start:
+    addi x10, x0, 1
+    slli x10, x10, 12       # base = 0x1000
+    addi x13, x10, 512      # end = base + 64 * 8
+fill:
+    addi x11, x10, 0
+    addi x12, x0, 64
+fill_loop:
+    sd   x12, 0(x11)
+    addi x12, x12, -1
+    addi x11, x11, 8
+    beq  x11, x13, sort
+    jal  x0, fill_loop
+sort:
+    addi x14, x13, -8       # last index of the unsorted part
+pass:
+    beq  x14, x10, fill
+    addi x11, x10, 0
+inner:
+    beq  x11, x14, pass_done
+    ld   x15, 0(x11)
+    ld   x16, 8(x11)
+    slt  x17, x16, x15      # a[j + 1] < a[j]
+    beq  x17, x0, no_swap
+    sd   x16, 0(x11)
+    sd   x15, 8(x11)
+no_swap:
+    addi x11, x11, 8
+    jal  x0, inner
+pass_done:
+    addi x14, x14, -8
+    jal  x0, pass
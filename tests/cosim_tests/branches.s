@@ -0,0 +1,52 @@
+.section .text
+.global _start
+
+# Все условия переходов, вызов и возврат через jalr, зависимости операндов перехода
+# от только что вычисленных значений, загрузок и произведений (EARLY_BRANCH ждёт их в Decode)
+_start:
+    addi x1, x0, 0
+    addi x2, x0, 10
+count_up:
+    addi x1, x1, 1
+    bne x1, x2, count_up
+
+    addi x3, x0, -5
+    addi x4, x0, 0
+signed_loop:
+    addi x4, x4, 1
+    addi x3, x3, 1
+    blt x3, x0, signed_loop
+
+    addi x5, x0, -1
+    bltu x5, x2, wrong
+    bgeu x5, x2, unsigned_ok
+wrong:
+    addi x20, x0, 500
+unsigned_ok:
+    bge x0, x5, ge_taken
+    addi x21, x0, 501
+ge_taken:
+    sd x2, 0x30(x0)
+    ld x6, 0x30(x0)
+    beq x6, x2, load_ok
+    addi x22, x0, 502
+load_ok:
+    mul x7, x2, x2
+    bne x7, x2, mul_ok
+    addi x23, x0, 503
+mul_ok:
+    jal x1, func
+    addi x8, x8, 1
+    jal x1, func
+    addi x8, x8, 1
+    beq x0, x0, end
+func:
+    addi x9, x9, 3
+    jalr x0, 0(x1)
+end:
+    addi x10, x0, 0
+    nop
+    nop
+    nop
+    nop
+    sret
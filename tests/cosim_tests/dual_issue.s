@@ -0,0 +1,55 @@
+.section .text
+.global _start
+
+# Пары для DUAL_ISSUE: независимые ALU-команды вторым слотом, запись обоими слотами
+# в один регистр, пересылка из второго слота Memory/Writeback в оба слота Execute,
+# загрузка и умножение перед парой, переход перед парой и пары на границе строки кэша
+_start:
+    addi x1, x0, 5
+    addi x2, x0, 7
+    add x3, x1, x2
+    sub x4, x2, x1
+    xor x5, x3, x4
+    or x6, x3, x4
+    and x7, x5, x6
+    slli x8, x6, 3
+    addi x9, x0, 1
+    addi x9, x0, 2
+    add x10, x9, x9
+    sll x11, x10, x9
+
+    sd x11, 0x40(x0)
+    addi x12, x0, 3
+    ld x13, 0x40(x0)
+    addi x14, x12, 1
+    add x15, x13, x14
+    sub x16, x15, x12
+    mul x17, x16, x2
+    addi x18, x17, 1
+    srai x19, x17, 1
+
+    addi x20, x0, 0
+    addi x21, x0, 20
+loop:
+    addi x20, x20, 1
+    andi x22, x20, 3
+    add x23, x23, x22
+    slti x24, x20, 10
+    add x25, x25, x24
+    bne x20, x21, loop
+
+    addi x26, x0, 0
+    beq x26, x0, target
+    addi x26, x0, 100
+    addi x27, x0, 101
+target:
+    addi x27, x27, 1
+    addi x28, x26, 2
+    sltu x29, x28, x27
+    srl x30, x23, x29
+    addi x31, x0, 0
+    nop
+    nop
+    nop
+    nop
+    sret
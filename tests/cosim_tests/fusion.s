@@ -0,0 +1,68 @@
+.section .text
+.global _start
+
+# Пары, которые сливает MACRO_FUSION: lui+addi (в т.ч. с отрицательной младшей частью),
+# auipc+jalr (дальний вызов), slt[u]+bnez/beqz в обе стороны; одиночные lui/auipc
+# и пары, которые сливать нельзя (другой rd, rd = x0, сравнение не с x0)
+_start:
+    lui x1, 0x12345
+    addi x1, x1, 0x678
+    lui x2, 0xfffff
+    addi x2, x2, -1
+    lui x3, 0x80000
+    addi x3, x3, -2048
+    lui x4, 0x1
+    addi x5, x4, 1
+    lui x6, 0x7ffff
+    auipc x7, 0
+    auipc x8, 0x10
+    addi x8, x8, 16
+
+    call far_func
+    addi x9, x9, 1
+    call far_func
+    addi x9, x9, 1
+
+    addi x10, x0, -1
+    addi x11, x0, 5
+    slt x12, x10, x11
+    bnez x12, slt_taken
+    addi x20, x0, 500
+slt_taken:
+    sltu x13, x10, x11
+    bnez x13, wrong
+    slt x14, x11, x10
+    beqz x14, slt_eq_taken
+wrong:
+    addi x21, x0, 501
+slt_eq_taken:
+    sltu x15, x11, x10
+    beqz x15, wrong_2
+    addi x16, x0, 0
+count_down:
+    addi x16, x16, 1
+    slt x17, x16, x11
+    bnez x17, count_down
+    slt x18, x10, x11
+    bne x18, x11, not_fused
+wrong_2:
+    addi x22, x0, 502
+not_fused:
+    slt x0, x10, x11
+    beq x0, x0, end
+
+func_pad:
+    nop
+    nop
+far_func:
+    addi x19, x19, 3
+    add x19, x19, x1
+    jalr x0, 0(x1)
+
+end:
+    addi x23, x0, 0
+    nop
+    nop
+    nop
+    nop
+    sret
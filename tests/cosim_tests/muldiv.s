@@ -0,0 +1,65 @@
+.section .text
+.global _start
+
+# M-расширение: умножитель (результат в Memory, зависимая инструкция ждёт такт),
+# итеративный делитель (держит Execute), деление на ноль и MIN / -1, W-варианты
+_start:
+    addi x1, x0, 7
+    addi x2, x0, -3
+    mul x3, x1, x2
+    add x4, x3, x1
+    mul x5, x3, x3
+    mul x6, x5, x2
+    mulh x7, x2, x1
+    mulhu x8, x2, x1
+    mulhsu x9, x2, x1
+    mulhsu x10, x1, x2
+
+    # x11 = 0x8000000000000000, x12 = -1
+    addi x11, x0, 1
+    slli x11, x11, 63
+    addi x12, x0, -1
+    mulh x13, x11, x11
+    mulhu x14, x12, x12
+    mul x15, x11, x12
+
+    div x16, x1, x2
+    rem x17, x1, x2
+    divu x18, x2, x1
+    remu x19, x2, x1
+    add x20, x16, x17
+    div x21, x11, x12
+    rem x22, x11, x12
+    div x23, x1, x0
+    divu x24, x1, x0
+    rem x25, x2, x0
+    remu x26, x2, x0
+
+    # W-варианты: x27 = 0x00000000_80000005
+    addi x27, x0, 1
+    slli x27, x27, 31
+    addi x27, x27, 5
+    mulw x28, x27, x1
+    divw x29, x27, x2
+    divuw x30, x27, x1
+    remw x31, x27, x2
+    remuw x3, x27, x1
+    divw x4, x11, x12
+    remw x5, x2, x0
+    divuw x6, x27, x0
+
+    # Цепочка делитель -> store -> load -> умножение
+    div x7, x27, x1
+    sd x7, 0x20(x0)
+    ld x8, 0x20(x0)
+    mul x9, x8, x1
+    divu x10, x9, x8
+    beq x10, x1, end
+    addi x10, x0, 500
+end:
+    addi x13, x0, 0
+    nop
+    nop
+    nop
+    nop
+    sret
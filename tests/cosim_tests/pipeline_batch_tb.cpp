@@ -0,0 +1,164 @@
+// Пакетная lockstep-сверка: много программ в одном процессе. Каждый рабочий поток берёт
+// следующую программу из общей очереди и прогоняет её на собственном экземпляре
+// PipelineHarness (свой VerilatedContext: время, plusargs, области DPI) против своего RefHart.
+// Запуск процесса и разбор опций делаются один раз на весь пакет.
+//
+// Список (--batch): по строке на программу, "<elf>" или "<имя> <elf>"; пустые строки и
+// строки с # пропускаются. Остальные опции (--max-cycles, --pc-start, ...) общие для всех.
+#include "pipeline_harness.h"
+#include "sim_options.h"
+#include "lockstep.h"
+#include "ref_hart.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct BatchJob {
+    std::string name;
+    std::string elf_file;
+};
+
+struct BatchResult {
+    bool passed = false;
+    uint64_t cycles = 0;
+    uint64_t commits = 0;
+    double seconds = 0.0;
+    std::string message;
+};
+
+static bool read_batch_list(const std::string& path, std::vector<BatchJob>& jobs) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open batch list: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string first;
+        std::string second;
+        if (!(fields >> first) || first[0] == '#') {
+            continue;
+        }
+        BatchJob job;
+        if (fields >> second) {
+            job.name = first;
+            job.elf_file = second;
+        } else {
+            job.elf_file = first;
+            size_t slash = first.find_last_of('/');
+            job.name = first.substr(slash == std::string::npos ? 0 : slash + 1);
+            job.name = job.name.substr(0, job.name.find_last_of('.'));
+        }
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+// Одна программа: до инструкции SYSTEM с остановом эталона в той же точке,
+// сторожевой предел -- opts.max_cycles
+static void run_job(SimOptions opts, const BatchJob& job, BatchResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    opts.test_name = job.name;
+    opts.elf_file = job.elf_file;
+    opts.quiet = true;
+
+    PipelineHarness harness(opts);
+    if (!harness.load_program()) {
+        result.message = "could not load " + job.elf_file;
+        return;
+    }
+    Vpipeline* top = harness.top();
+
+    RefHart ref;
+    ref.load(harness.program_image());
+    ref.set_pc(top->pc_start_i);
+    LockstepChecker checker(ref);
+    if (!harness.start(&ref)) {
+        result.message = "could not start";
+        return;
+    }
+
+    bool ok = true;
+    bool halted = false;
+    while (ok && !halted && harness.cycle() < opts.max_cycles) {
+        harness.tick();
+        RegWrite writes[2];
+        const int num_writes = harness.reg_writes(writes);
+        for (int i = 0; i < num_writes && ok; ++i) {
+            ok = checker.on_rtl_write(harness.cycle(), writes[i].pc, writes[i].rd, writes[i].value, writes[i].fused);
+        }
+        if (ok && harness.halted()) {
+            halted = true;
+            ok = checker.on_rtl_halt(harness.cycle(), top->pc_w_o);
+        }
+    }
+
+    result.cycles = harness.cycle();
+    result.commits = checker.commits_checked();
+    result.passed = ok && halted;
+    if (!ok) {
+        result.message = "mismatch with the reference at cycle " + std::to_string(harness.cycle());
+    } else if (!halted) {
+        result.message = "watchdog expired after " + std::to_string(opts.max_cycles) + " cycles";
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    SimOptions opts;
+    if (!parse_sim_options(argc, argv, opts) || opts.batch.list_file.empty() || opts.max_cycles == 0) {
+        std::cerr << "ERROR: Batch co-simulation needs --batch <elf_list> and --max-cycles." << std::endl;
+        print_sim_options_usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<BatchJob> jobs;
+    if (!read_batch_list(opts.batch.list_file, jobs)) {
+        return 1;
+    }
+    unsigned workers = opts.batch.jobs ? opts.batch.jobs : std::thread::hardware_concurrency();
+    workers = std::max(1u, std::min<unsigned>(workers, static_cast<unsigned>(jobs.size())));
+    std::cout << "BATCH: " << jobs.size() << " program(s) on " << workers << " model instance(s)" << std::endl;
+
+    std::vector<BatchResult> results(jobs.size());
+    std::atomic<size_t> next_job(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < workers; ++i) {
+        threads.emplace_back([&]() {
+            for (size_t index = next_job++; index < jobs.size(); index = next_job++) {
+                run_job(opts, jobs[index], results[index]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t passed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const BatchResult& result = results[i];
+        passed += result.passed ? 1 : 0;
+        std::cout << (result.passed ? "BATCH PASS " : "BATCH FAIL ") << jobs[i].name << ": " << result.cycles
+                  << " cycles, " << result.commits << " register writes matched, " << std::fixed
+                  << std::setprecision(3) << result.seconds << " s" << std::defaultfloat;
+        if (!result.message.empty()) {
+            std::cout << " (" << result.message << ")";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "BATCH: " << passed << "/" << jobs.size() << " passed in " << std::fixed << std::setprecision(3)
+              << seconds << " s (" << std::setprecision(1) << jobs.size() / seconds << " programs/s)"
+              << std::defaultfloat << std::endl;
+    return passed == jobs.size() ? 0 : 1;
+}
@@ -1,105 +1,249 @@
-#include "Vpipeline.h"
-#include "verilated_vcd_c.h"
-#include "verilated.h"
+#include "pipeline_harness.h"
+#include "sim_options.h"
+#include "lockstep.h"
+#include "ref_hart.h"
+#include "commit_trace.h"
+#include "arch_state.h"
+#include "stage_bundles.h"
 
 #include <iostream>
-#include <fstream>
-#include <iomanip>
 #include <string>
-#include <vector>
-#include <sstream>
-#include <cstdlib> // Для std::getenv
 
-// Макросы, определяемые CMake
-#ifndef PIPELINE_COSIM_TEST_CASE_NAME_STR_RAW
-#error "PIPELINE_COSIM_TEST_CASE_NAME_STR_RAW not defined!"
-#endif
-
-#ifndef NUM_CYCLES_TO_RUN
-#error "NUM_CYCLES_TO_RUN not defined!"
-#endif
-
-#ifndef VERILOG_OUTPUT_FILE_PATH_STR_RAW // Имя файла, куда будет писать Verilog тестбенч
-#error "VERILOG_OUTPUT_FILE_PATH_STR_RAW not defined!"
-#endif
-
-
-// Вспомогательные макросы для превращения в строку
-#define STRINGIFY_HELPER(x) #x
-#define STRINGIFY(x) STRINGIFY_HELPER(x)
+// После posedge clk, когда все сигналы WB стадии стабилизировались
+void record_reg_write(const RegWrite& write, uint64_t cycle, CommitTraceWriter& writer) {
+    if (writer.is_open()) {
+        CommitRecord record;
+        record.cycle = cycle;
+        record.pc = write.pc;
+        record.rd = write.rd;
+        record.value = write.value;
+        record.flags = COMMIT_REG_WRITE | COMMIT_PC_VALID | (write.fused ? COMMIT_FUSED : 0);
+        writer.append(record);
+    }
+}
 
-// Глобальные переменные из макросов
-const std::string G_PIPELINE_COSIM_TEST_CASE_NAME = STRINGIFY(PIPELINE_COSIM_TEST_CASE_NAME_STR_RAW);
-const int G_NUM_CYCLES_TO_RUN = NUM_CYCLES_TO_RUN;
-const std::string G_VERILOG_OUTPUT_FILE_PATH = STRINGIFY(VERILOG_OUTPUT_FILE_PATH_STR_RAW);
+// Store в Memory младше инструкций в Writeback, поэтому пишется после их записей в регистры
+void record_mem_write(const MemWrite& write, uint64_t cycle, CommitTraceWriter& writer) {
+    if (writer.is_open()) {
+        CommitRecord record;
+        record.cycle = cycle;
+        record.pc = write.pc;
+        record.mem_addr = write.addr;
+        record.mem_data = write.data;
+        record.flags = COMMIT_MEM_WRITE | COMMIT_PC_VALID;
+        writer.append(record);
+    }
+}
 
-vluint64_t sim_time = 0;
+// Сверка записей в регистры за такт; halted -- RTL дошёл до инструкции SYSTEM
+bool check_cycle(PipelineHarness& harness, LockstepChecker& checker, CommitTraceWriter& writer, bool& halted) {
+    bool ok = true;
+    RegWrite writes[2];
+    const int num_writes = harness.reg_writes(writes);
+    for (int i = 0; i < num_writes && ok; ++i) {
+        record_reg_write(writes[i], harness.cycle(), writer);
+        ok = checker.on_rtl_write(harness.cycle(), writes[i].pc, writes[i].rd, writes[i].value, writes[i].fused);
+    }
+    if (ok && harness.halted()) {
+        halted = true;
+        ok = checker.on_rtl_halt(harness.cycle(), harness.top()->pc_w_o);
+    }
+    // Store после инструкции SYSTEM уже не входит в программу
+    MemWrite store;
+    if (ok && !halted && harness.mem_write(store)) {
+        record_mem_write(store, harness.cycle(), writer);
+    }
+    return ok;
+}
 
-double sc_time_stamp() {
-    return sim_time;
+// Сразу после load_arch_state: выборка стоит на PC эталона, стадии с Decode по Writeback
+// пусты, регистры совпадают с эталоном, счётчики обнулены. Инструкция перед точкой
+// переноса или остаток прежнего окна здесь испортили бы и сверку, и выборку.
+bool check_injected_state(PipelineHarness& harness, const RefHart& ref) {
+    const Vpipeline& top = *harness.top();
+    if (top.pc_f_o != ref.pc()) {
+        std::cerr << "ERROR: Fetch at pc 0x" << std::hex << top.pc_f_o << " after load_arch_state, reference at 0x"
+                  << ref.pc() << std::dec << "." << std::endl;
+        return false;
+    }
+    StageBundles stages;
+    read_stage_bundles(top, stages);
+    if (stages.if_id.pc_4 != 0 || stages.id_ex.pc_4 != 0 || stages.ex_mem.pc_4 != 0 || stages.mem_wb.pc_4 != 0) {
+        std::cerr << "ERROR: Pipeline not empty after load_arch_state (D/E/M/W pc+4: 0x" << std::hex
+                  << stages.if_id.pc_4 << " 0x" << stages.id_ex.pc_4 << " 0x" << stages.ex_mem.pc_4 << " 0x"
+                  << stages.mem_wb.pc_4 << std::dec << ")." << std::endl;
+        return false;
+    }
+    RegfileAccess regfile;
+    for (unsigned i = 1; i < 32; ++i) {
+        if (regfile.read(i) != ref.reg(i)) {
+            std::cerr << "ERROR: x" << i << " = 0x" << std::hex << regfile.read(i) << " after load_arch_state, "
+                      << "reference has 0x" << ref.reg(i) << std::dec << "." << std::endl;
+            return false;
+        }
+    }
+    if (harness.perf_counter(PERF_INSTRET) != 0) {
+        std::cerr << "ERROR: INSTRET = " << harness.perf_counter(PERF_INSTRET) << " after load_arch_state."
+                  << std::endl;
+        return false;
+    }
+    return true;
 }
 
-void tick(Vpipeline* top, VerilatedVcdC* tfp, std::ofstream& outFile) {
-    top->clk_i = 0;
-    top->eval();
-    if (tfp) tfp->dump(sim_time);
-    sim_time++;
-
-    top->clk_i = 1;
-    top->eval();
-    if (tfp) tfp->dump(sim_time);
-    // После posedge clk, когда все сигналы WB стадии стабилизировались
-    if (top->we3_d_o) { // Если есть запись в регистровый файл
-        if (outFile.is_open()) {
-            outFile << std::hex << std::setw(16) << std::setfill('0') << top->wd3_d_o << std::endl;
+// Окна как у выборочного моделирования (--samples): эталон выполняет --sample-interval
+// инструкций, состояние переносится в модель, которая уже работала, и следующие
+// --sample-window записей в регистры сверяются в lockstep.
+int run_windows(PipelineHarness& harness, RefHart& ref, const SimOptions& opts, uint64_t cycle_limit) {
+    const SamplingOptions& sampling = opts.sampling;
+    CommitTraceWriter no_trace;
+    uint64_t windows = 0;
+    uint64_t commits = 0;
+    for (; windows < sampling.samples; ++windows) {
+        if (ref.run(sampling.interval) != RefHart::StepResult::Ok) {
+            break;
+        }
+        if (!harness.load_arch_state(ref) || !check_injected_state(harness, ref)) {
+            std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED at window " << windows
+                      << std::endl;
+            return 1;
+        }
+
+        LockstepChecker checker(ref);
+        bool halted = false;
+        while (!halted && checker.commits_checked() < sampling.window) {
+            if (harness.cycle() >= cycle_limit) {
+                harness.report_failure();
+                std::cout << "VERILOG SIM: Watchdog expired in window " << windows << "." << std::endl;
+                std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED" << std::endl;
+                return 1;
+            }
+            harness.tick();
+            if (!check_cycle(harness, checker, no_trace, halted)) {
+                harness.report_failure();
+                std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED in window " << windows
+                          << " at cycle " << harness.cycle() << std::endl;
+                return 1;
+            }
         }
+        commits += checker.commits_checked();
+        if (halted) {
+            ++windows;
+            break;
+        }
+    }
+
+    if (windows == 0) {
+        std::cerr << "VERILOG SIM ERROR: Program ended before the first window." << std::endl;
+        return 1;
     }
-    sim_time++;
+    std::cout << "VERILOG SIM: " << windows << " windows re-injected, " << commits
+              << " register writes matched the reference." << std::endl;
+    std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - PASSED" << std::endl;
+    return 0;
 }
 
 int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
-    Vpipeline* top = new Vpipeline;
-
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    std::string vcd_file_name = G_PIPELINE_COSIM_TEST_CASE_NAME + "_cosim_verilog_tb.vcd";
-    tfp->open(vcd_file_name.c_str());
-
-    std::cout << "VERILOG SIM: Starting Co-simulation Test Case: " << G_PIPELINE_COSIM_TEST_CASE_NAME << std::endl;
-    std::cout << "VERILOG SIM: Number of cycles to run: " << G_NUM_CYCLES_TO_RUN << std::endl;
-    std::cout << "VERILOG SIM: Output file: " << G_VERILOG_OUTPUT_FILE_PATH << std::endl;
-
-    std::ofstream verilog_output_file(G_VERILOG_OUTPUT_FILE_PATH, std::ios::out | std::ios::trunc);
-    if (!verilog_output_file.is_open()) {
-        std::cerr << "VERILOG SIM ERROR: Could not open output file: " << G_VERILOG_OUTPUT_FILE_PATH << std::endl;
-        if (tfp) tfp->close();
-        delete top;
+
+    SimOptions opts;
+    if (!parse_sim_options(argc, argv, opts) || opts.elf_file.empty()) {
+        std::cerr << "VERILOG SIM ERROR: Co-simulation needs the program as --elf." << std::endl;
+        print_sim_options_usage(argv[0]);
+        return 1;
+    }
+
+    std::cout << "VERILOG SIM: Starting Co-simulation Test Case: " << opts.test_name << std::endl;
+    // --cycles -- ровно столько тактов, --max-cycles -- до инструкции SYSTEM со сторожевым пределом
+    const uint64_t cycle_limit = opts.num_cycles ? opts.num_cycles : opts.max_cycles;
+    if (cycle_limit == 0) {
+        std::cerr << "VERILOG SIM ERROR: Either --cycles or --max-cycles is required." << std::endl;
         return 1;
     }
+    std::cout << "VERILOG SIM: " << (opts.num_cycles ? "Number of cycles to run: " : "Running until halt, watchdog: ")
+              << cycle_limit << std::endl;
+
+    // Двоичная commit-трасса (commit_trace.h): сверка с внешним Simulator и другие анализаторы
+    CommitTraceWriter commit_trace;
+    if (!opts.output_file.empty()) {
+        std::cout << "VERILOG SIM: Output file: " << opts.output_file << std::endl;
+        if (!commit_trace.open(opts.output_file)) {
+            std::cerr << "VERILOG SIM ERROR: Could not open output file: " << opts.output_file << std::endl;
+            return 1;
+        }
+    }
 
-    top->rst_i = 1;
-    for(int i=0; i<2; ++i) {
-        // Во время сброса не пишем в файл вывода
-        top->clk_i = 0; top->eval(); if (tfp) tfp->dump(sim_time); sim_time++;
-        top->clk_i = 1; top->eval(); if (tfp) tfp->dump(sim_time); sim_time++;
+    // Окна сверяются от точек переноса, а не от начала программы
+    if (opts.sampling.samples > 0 && (!opts.output_file.empty() || opts.fast_forward > 0)) {
+        std::cerr << "VERILOG SIM ERROR: --samples cannot be combined with --output or --fast-forward." << std::endl;
+        return 1;
     }
-    top->rst_i = 0;
-    std::cout << "VERILOG SIM: Reset complete." << std::endl;
 
-    for (int cycle = 0; cycle < G_NUM_CYCLES_TO_RUN; ++cycle) {
-        tick(top, tfp, verilog_output_file);
+    // Эталонная модель начинает с начала программы, её состояния в контрольной точке нет
+    if (!opts.checkpoint.restore_file.empty()) {
+        std::cerr << "VERILOG SIM ERROR: --checkpoint-restore is not supported by this testbench." << std::endl;
+        return 1;
+    }
+
+    PipelineHarness harness(opts);
+    if (!harness.load_program()) {
+        return 1;
+    }
+    if (!harness.open_trace(opts.test_name + "_cosim_verilog_tb")) {
+        return 1;
+    }
+    Vpipeline* top = harness.top();
+
+    RefHart ref;
+    ref.load(harness.program_image());
+    ref.set_pc(top->pc_start_i);
+
+    // Во время сброса не пишем в файл вывода. С --fast-forward эталон сам выполняет
+    // начало программы, и сверка идёт с точки переноса состояния в RTL.
+    if (!harness.start(&ref)) {
+        return 1;
+    }
+    if (opts.fast_forward > 0 && !check_injected_state(harness, ref)) {
+        std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED after fast-forward" << std::endl;
+        return 1;
+    }
+    std::cout << "VERILOG SIM: Reset complete." << std::endl;
+    if (opts.sampling.samples > 0) {
+        return run_windows(harness, ref, opts, cycle_limit);
     }
 
-    std::cout << "VERILOG SIM: Simulation finished after " << G_NUM_CYCLES_TO_RUN << " cycles." << std::endl;
+    // С --fast-forward часть инструкций эталон выполнил до переноса, RTL их не видел
+    const uint64_t ref_instret_start = ref.instret();
+    LockstepChecker checker(ref);
+    bool halted = false;
+    while (harness.cycle() < cycle_limit) {
+        harness.tick();
+
+        if (!check_cycle(harness, checker, commit_trace, halted)) {
+            harness.report_failure();
+            std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED at cycle "
+                      << harness.cycle() << std::endl;
+            return 1;
+        }
+        if (halted) {
+            break;
+        }
+    }
 
-    if (verilog_output_file.is_open()) {
-        verilog_output_file.close();
+    if (!halted && !opts.num_cycles) {
+        harness.report_failure();
+        std::cout << "VERILOG SIM: Watchdog expired after " << cycle_limit << " cycles without a halt." << std::endl;
+        std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED" << std::endl;
+        return 1;
     }
-    if (tfp) {
-        tfp->close();
+    // Инструкция SYSTEM в Writeback ещё не посчитана, эталон на ней остановился и тоже её не считает
+    if (halted && harness.perf_counter(PERF_INSTRET) != ref.instret() - ref_instret_start) {
+        std::cerr << "ERROR: INSTRET = " << harness.perf_counter(PERF_INSTRET) << " at halt, the reference retired "
+                  << ref.instret() - ref_instret_start << " instructions." << std::endl;
+        std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - FAILED" << std::endl;
+        return 1;
     }
-    delete top;
-    return 0; // Успешное завершение Verilog-части
-}
\ No newline at end of file
+    std::cout << "VERILOG SIM: Simulation " << (halted ? "halted" : "finished") << " after " << harness.cycle()
+              << " cycles, " << checker.commits_checked() << " register writes matched the reference." << std::endl;
+    std::cout << "\nCo-simulation Test Case: " << opts.test_name << " - PASSED" << std::endl;
+    return 0;
+}
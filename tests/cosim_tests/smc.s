@@ -0,0 +1,47 @@
+.section .text
+.global _start
+
+# Самомодифицирующийся код для кэша блоков RefHart (RTL читает инструкции из ram_instr
+# и такую программу не исполняет). Результат сверяет сама программа: при ошибке --
+# недопустимая инструкция, ref_trace завершается с кодом 1.
+_start:
+    # 1) Запись в инструкцию дальше в том же блоке, до её выполнения
+    la x10, patch_same
+    lw x11, addi_x5_2
+    sw x11, 0(x10)
+patch_same:
+    addi x5, x0, 1
+    addi x6, x0, 2
+    bne x5, x6, fail
+
+    # 2) Запись в блок, который уже выполнялся и лежит в кэше
+    jal x1, func
+    addi x8, x0, 1
+    bne x7, x8, fail
+    la x10, func
+    lw x11, addi_x7_3
+    sw x11, 0(x10)
+    jal x1, func
+    addi x8, x0, 3
+    bne x7, x8, fail
+
+    # 3) Запись в слово рядом с кодом той же страницы: блоки func остаются верными
+    la x10, scratch
+    sw x8, 0(x10)
+    jal x1, func
+    bne x7, x8, fail
+    ebreak
+
+fail:
+    .word 0
+
+func:
+    addi x7, x0, 1
+    jalr x0, 0(x1)
+
+addi_x5_2:
+    .word 0x00200293        # addi x5, x0, 2
+addi_x7_3:
+    .word 0x00300393        # addi x7, x0, 3
+scratch:
+    .word 0
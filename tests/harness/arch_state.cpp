@@ -0,0 +1,40 @@
+#include "arch_state.h"
+
+#include "Vpipeline__Dpi.h"
+
+#include <iostream>
+
+#include "ram_access.h"
+
+RegfileAccess::RegfileAccess() : scope_(svGetScopeFromName(REGFILE_SCOPE)) {
+    if (!scope_) {
+        std::cerr << "ERROR: DPI scope not found: " << REGFILE_SCOPE << std::endl;
+    }
+}
+
+uint64_t RegfileAccess::read(unsigned index) const {
+    svSetScope(scope_);
+    return regfile_dpi_read(static_cast<int>(index & 31));
+}
+
+void RegfileAccess::write(unsigned index, uint64_t value) {
+    svSetScope(scope_);
+    regfile_dpi_write(static_cast<int>(index & 31), value);
+}
+
+bool inject_arch_state(const RefHart& hart) {
+    RegfileAccess regfile;
+    RamAccess ram_data(RAM_DATA_SCOPE);
+    if (!regfile.valid() || !ram_data.valid()) {
+        return false;
+    }
+
+    for (unsigned i = 1; i < 32; ++i) {
+        regfile.write(i, hart.reg(i));
+    }
+    // Память инструкций не трогаем: самомодифицирующийся код RTL всё равно не поддерживает
+    hart.for_each_page([&ram_data](uint64_t base, const uint8_t* data, size_t size) {
+        ram_data.write_bytes(base, data, size);
+    });
+    return true;
+}
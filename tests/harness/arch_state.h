@@ -0,0 +1,33 @@
+#ifndef ARCH_STATE_H
+#define ARCH_STATE_H
+
+#include "svdpi.h"
+
+#include <cstdint>
+
+#include "ref_hart.h"
+
+// Иерархическое имя экземпляра regfile внутри Vpipeline
+#define REGFILE_SCOPE "TOP.pipeline.regfile"
+
+// Прямой доступ к rf экземпляра regfile через экспортируемые DPI-функции
+// (regfile_dpi_read/regfile_dpi_write). x0 читается нулём, запись в него игнорируется.
+class RegfileAccess {
+public:
+    RegfileAccess();
+
+    bool valid() const { return scope_ != nullptr; }
+
+    uint64_t read(unsigned index) const;
+    void write(unsigned index, uint64_t value);
+
+private:
+    svScope scope_;
+};
+
+// Переносит архитектурное состояние эталонной модели в Vpipeline: x1..x31 -- в regfile,
+// все страницы памяти RefHart -- в ram_data. PC сюда не входит: его задаёт pc_start_i
+// на сбросе, поэтому вызывать после reset() с pc_start_i = hart.pc().
+bool inject_arch_state(const RefHart& hart);
+
+#endif // ARCH_STATE_H
@@ -0,0 +1,71 @@
+#include "checkpoint.h"
+
+#include <iostream>
+
+#ifndef PIPELINE_SAVABLE
+#define PIPELINE_SAVABLE 0
+#endif
+
+#if PIPELINE_SAVABLE
+#include "verilated_save.h"
+
+namespace {
+
+const char* const CHECKPOINT_MAGIC = "RISCV_VerilogSim checkpoint v1";
+
+} // namespace
+
+bool save_checkpoint(const std::string& path, Vpipeline* top, const CheckpointInfo& info) {
+    VerilatedSave os;
+    os.open(path.c_str());
+    if (!os.isOpen()) {
+        std::cerr << "ERROR: Could not create checkpoint file: " << path << std::endl;
+        return false;
+    }
+    std::string magic = CHECKPOINT_MAGIC;
+    uint64_t cycle = info.cycle;
+    uint64_t sim_time = info.sim_time;
+    os << magic << cycle << sim_time;
+    os << *top;
+    os.close();
+    std::cout << "Checkpoint saved at cycle " << info.cycle << ": " << path << std::endl;
+    return true;
+}
+
+bool restore_checkpoint(const std::string& path, Vpipeline* top, CheckpointInfo& info) {
+    VerilatedRestore is;
+    is.open(path.c_str());
+    if (!is.isOpen()) {
+        std::cerr << "ERROR: Could not open checkpoint file: " << path << std::endl;
+        return false;
+    }
+    std::string magic;
+    is >> magic;
+    if (magic != CHECKPOINT_MAGIC) {
+        std::cerr << "ERROR: Not a checkpoint of this model: " << path << std::endl;
+        return false;
+    }
+    is >> info.cycle >> info.sim_time;
+    is >> *top;
+    is.close();
+    std::cout << "Checkpoint restored at cycle " << info.cycle << ": " << path << std::endl;
+    return true;
+}
+
+#else
+
+static bool report_not_savable() {
+    std::cerr << "ERROR: The model was verilated without --savable; "
+                 "reconfigure with -DPIPELINE_SAVABLE=ON to use checkpoints." << std::endl;
+    return false;
+}
+
+bool save_checkpoint(const std::string&, Vpipeline*, const CheckpointInfo&) {
+    return report_not_savable();
+}
+
+bool restore_checkpoint(const std::string&, Vpipeline*, CheckpointInfo&) {
+    return report_not_savable();
+}
+
+#endif
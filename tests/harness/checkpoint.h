@@ -0,0 +1,21 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "Vpipeline.h"
+
+#include <cstdint>
+#include <string>
+
+// Полное состояние Vpipeline (регистры стадий, regfile.rf, обе ram, счётчики) через
+// VerilatedSave/VerilatedRestore. Модель должна быть верилирована с --savable
+// (CMake-опция PIPELINE_SAVABLE); разреженная память живёт в C++ и в точку не попадает,
+// поэтому с PIPELINE_SPARSE_MEM контрольные точки не поддерживаются.
+struct CheckpointInfo {
+    uint64_t cycle = 0;       // такт после сброса
+    uint64_t sim_time = 0;
+};
+
+bool save_checkpoint(const std::string& path, Vpipeline* top, const CheckpointInfo& info);
+bool restore_checkpoint(const std::string& path, Vpipeline* top, CheckpointInfo& info);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,65 @@
+#include "commit_trace.h"
+
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+CommitTraceReader::~CommitTraceReader() {
+    close();
+}
+
+bool CommitTraceReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "ERROR: Could not open commit trace: " << path << std::endl;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(CommitTraceHeader)) {
+        std::cerr << "ERROR: Commit trace is too short: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    mapping_size_ = static_cast<size_t>(st.st_size);
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        std::cerr << "ERROR: Could not map commit trace: " << path << std::endl;
+        return false;
+    }
+    madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+
+    const CommitTraceHeader* header = static_cast<const CommitTraceHeader*>(mapping_);
+    if (std::memcmp(header->magic, "RVCTRACE", sizeof(header->magic)) != 0 ||
+        header->version != COMMIT_TRACE_VERSION || header->record_size != sizeof(CommitRecord)) {
+        std::cerr << "ERROR: Not a version " << COMMIT_TRACE_VERSION << " commit trace: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    size_t payload = mapping_size_ - sizeof(CommitTraceHeader);
+    if (payload % sizeof(CommitRecord) != 0) {
+        std::cerr << "WARNING: Commit trace " << path << " ends with a truncated record, ignoring it" << std::endl;
+    }
+    records_ = reinterpret_cast<const CommitRecord*>(static_cast<const char*>(mapping_) + sizeof(CommitTraceHeader));
+    count_ = payload / sizeof(CommitRecord);
+    return true;
+}
+
+void CommitTraceReader::close() {
+    if (mapping_) {
+        munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    records_ = nullptr;
+    count_ = 0;
+}
@@ -0,0 +1,121 @@
+#ifndef COMMIT_TRACE_H
+#define COMMIT_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Двоичная трасса выполненных инструкций (commit trace): заголовок и массив записей
+// фиксированного размера в little-endian. Пишется тестбенчем cosim и плагином внешнего
+// симулятора, сравнивается commit_trace_diff.
+
+enum CommitFlags : uint8_t {
+    COMMIT_REG_WRITE = 1 << 0,  // rd/value действительны
+    COMMIT_MEM_WRITE = 1 << 1,  // mem_addr/mem_data действительны
+    COMMIT_PC_VALID  = 1 << 2,  // источник знает pc инструкции
+    COMMIT_FUSED     = 1 << 3,  // слитая пара (MACRO_FUSION): запись завершает и команду pc + 4
+};
+
+struct CommitRecord {
+    uint64_t cycle = 0;         // такт RTL или порядковый номер инструкции эталона
+    uint64_t pc = 0;
+    uint64_t value = 0;
+    uint64_t mem_addr = 0;
+    uint64_t mem_data = 0;
+    uint8_t rd = 0;
+    uint8_t flags = 0;
+    uint8_t reserved[6] = {0, 0, 0, 0, 0, 0};
+};
+static_assert(sizeof(CommitRecord) == 48, "CommitRecord layout is part of the file format");
+
+struct CommitTraceHeader {
+    char magic[8];              // "RVCTRACE"
+    uint32_t version;
+    uint32_t record_size;
+};
+static_assert(sizeof(CommitTraceHeader) == 16, "CommitTraceHeader layout is part of the file format");
+
+const uint32_t COMMIT_TRACE_VERSION = 1;
+
+// Потоковая запись с буфером: на диск уходят блоки по buffer_records записей.
+// Методы определены здесь же, чтобы писатель можно было собрать в плагин внешнего
+// симулятора без остальной обвязки.
+class CommitTraceWriter {
+public:
+    explicit CommitTraceWriter(size_t buffer_records = 8192) : capacity_(buffer_records) {
+        buffer_.reserve(capacity_);
+    }
+    ~CommitTraceWriter() { close(); }
+
+    CommitTraceWriter(const CommitTraceWriter&) = delete;
+    CommitTraceWriter& operator=(const CommitTraceWriter&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        file_ = std::fopen(path.c_str(), "wb");
+        if (!file_) {
+            return false;
+        }
+        CommitTraceHeader header = {{'R', 'V', 'C', 'T', 'R', 'A', 'C', 'E'},
+                                    COMMIT_TRACE_VERSION,
+                                    static_cast<uint32_t>(sizeof(CommitRecord))};
+        return std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    }
+
+    bool is_open() const { return file_ != nullptr; }
+
+    void append(const CommitRecord& record) {
+        buffer_.push_back(record);
+        if (buffer_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    void flush() {
+        if (file_ && !buffer_.empty()) {
+            std::fwrite(buffer_.data(), sizeof(CommitRecord), buffer_.size(), file_);
+        }
+        buffer_.clear();
+    }
+
+    void close() {
+        if (file_) {
+            flush();
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+private:
+    std::FILE* file_ = nullptr;
+    size_t capacity_;
+    std::vector<CommitRecord> buffer_;
+};
+
+// Чтение через mmap: записи доступны как массив без разбора и копирования.
+class CommitTraceReader {
+public:
+    CommitTraceReader() = default;
+    ~CommitTraceReader();
+
+    CommitTraceReader(const CommitTraceReader&) = delete;
+    CommitTraceReader& operator=(const CommitTraceReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    size_t size() const { return count_; }
+    const CommitRecord& operator[](size_t index) const { return records_[index]; }
+    const CommitRecord* begin() const { return records_; }
+    const CommitRecord* end() const { return records_ + count_; }
+
+private:
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const CommitRecord* records_ = nullptr;
+    size_t count_ = 0;
+};
+
+#endif // COMMIT_TRACE_H
@@ -0,0 +1,144 @@
+// Сравнение двух двоичных commit-трасс.
+// По умолчанию сравниваются только записи в регистры (внешний Simulator пишет только их);
+// --all добавляет записи в память с адресом и данными. Инструкции без записей (переходы,
+// nop) эталон пишет, а RTL нет, поэтому они пропускаются в обоих режимах.
+// pc сверяется, если оба источника его знают.
+// Слитой паре RTL (COMMIT_FUSED) в другой трассе соответствуют записи pc и pc + 4.
+#include "commit_trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const size_t CONTEXT_RECORDS = 8;
+
+std::vector<size_t> select_records(const CommitTraceReader& trace, bool all) {
+    std::vector<size_t> indices;
+    indices.reserve(trace.size());
+    for (size_t i = 0; i < trace.size(); ++i) {
+        if (trace[i].flags & (all ? COMMIT_REG_WRITE | COMMIT_MEM_WRITE : COMMIT_REG_WRITE)) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
+
+// Очередная запись трассы. Если на той же позиции другой трассы слитая пара, а здесь
+// следом идёт запись команды pc + 4, обе объединяются: pc первой, запись в регистр --
+// последняя в паре (вторая команда перезаписывает rd первой или не пишет вовсе).
+CommitRecord next_record(const CommitTraceReader& trace, const std::vector<size_t>& indices, size_t& n,
+                         bool merge_pair) {
+    CommitRecord record = trace[indices[n++]];
+    if (merge_pair && n < indices.size() && (record.flags & COMMIT_PC_VALID)) {
+        const CommitRecord& second = trace[indices[n]];
+        if ((second.flags & COMMIT_PC_VALID) && second.pc == record.pc + 4) {
+            if (second.flags & COMMIT_REG_WRITE) {
+                record.rd = second.rd;
+                record.value = second.value;
+                record.flags |= COMMIT_REG_WRITE;
+            }
+            ++n;
+        }
+    }
+    return record;
+}
+
+bool merges_with(const CommitRecord& record, const CommitRecord& other) {
+    return (other.flags & COMMIT_FUSED) && !(record.flags & COMMIT_FUSED);
+}
+
+bool records_match(const CommitRecord& a, const CommitRecord& b) {
+    const uint8_t both = a.flags & b.flags;
+    if ((a.flags ^ b.flags) & (COMMIT_REG_WRITE | COMMIT_MEM_WRITE)) {
+        return false;
+    }
+    if ((both & COMMIT_REG_WRITE) && (a.rd != b.rd || a.value != b.value)) {
+        return false;
+    }
+    if ((both & COMMIT_MEM_WRITE) && (a.mem_addr != b.mem_addr || a.mem_data != b.mem_data)) {
+        return false;
+    }
+    if ((both & COMMIT_PC_VALID) && a.pc != b.pc) {
+        return false;
+    }
+    return true;
+}
+
+void print_record(const char* label, const CommitRecord& r) {
+    std::cout << "  " << label << std::dec << " cycle " << std::setw(8) << r.cycle << std::hex << std::setfill('0');
+    if (r.flags & COMMIT_PC_VALID) {
+        std::cout << " | pc 0x" << std::setw(8) << r.pc;
+    }
+    if (r.flags & COMMIT_REG_WRITE) {
+        std::cout << " | x" << std::dec << static_cast<int>(r.rd) << std::hex << " <= 0x" << std::setw(16) << r.value;
+    }
+    if (r.flags & COMMIT_MEM_WRITE) {
+        std::cout << " | mem[0x" << std::setw(8) << r.mem_addr << "] <= 0x" << std::setw(16) << r.mem_data;
+    }
+    if (r.flags & COMMIT_FUSED) {
+        std::cout << " | fused";
+    }
+    std::cout << std::dec << std::setfill(' ') << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool all = false;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--all") == 0) {
+            all = true;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.size() != 2) {
+        std::cerr << "Usage: " << argv[0] << " [--all] <trace_a.bin> <trace_b.bin>" << std::endl;
+        return 2;
+    }
+
+    CommitTraceReader a, b;
+    if (!a.open(files[0]) || !b.open(files[1])) {
+        return 2;
+    }
+    std::vector<size_t> ia = select_records(a, all);
+    std::vector<size_t> ib = select_records(b, all);
+    std::cout << "Read " << ia.size() << " records from " << files[0] << std::endl;
+    std::cout << "Read " << ib.size() << " records from " << files[1] << std::endl;
+
+    size_t na = 0;
+    size_t nb = 0;
+    size_t common = 0;
+    while (na < ia.size() && nb < ib.size()) {
+        const size_t first_a = na;
+        const bool merge_a = merges_with(a[ia[na]], b[ib[nb]]);
+        const bool merge_b = merges_with(b[ib[nb]], a[ia[na]]);
+        const CommitRecord ra = next_record(a, ia, na, merge_a);
+        const CommitRecord rb = next_record(b, ib, nb, merge_b);
+        if (records_match(ra, rb)) {
+            ++common;
+            continue;
+        }
+        std::cout << "\nMISMATCH at record " << common << ". Preceding records:\n";
+        for (size_t k = (first_a > CONTEXT_RECORDS ? first_a - CONTEXT_RECORDS : 0); k < first_a; ++k) {
+            print_record("   ", a[ia[k]]);
+        }
+        print_record("A: ", ra);
+        print_record("B: ", rb);
+        std::cout << "\nTraces DIFFER" << std::endl;
+        return 1;
+    }
+
+    // RTL прогоняется ограниченное число тактов, поэтому разная длина -- не ошибка
+    if (na != ia.size() || nb != ib.size()) {
+        std::cout << "Warning: traces have different lengths (" << ia.size() << " vs " << ib.size()
+                  << "), compared the first " << common << " records" << std::endl;
+    }
+    std::cout << "\nTraces MATCH (" << common << " records)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "elf_loader.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+
+const uint8_t ELF_MAGIC[4] = {0x7F, 'E', 'L', 'F'};
+const uint8_t ELFCLASS64 = 2;
+const uint8_t ELFDATA2LSB = 1;
+const uint16_t EM_RISCV = 243;
+const uint32_t PT_LOAD = 1;
+const uint32_t PF_X = 1;
+const uint32_t SHT_SYMTAB = 2;
+const uint16_t SHN_UNDEF = 0;
+const uint16_t SHN_LORESERVE = 0xff00;
+const uint8_t STT_NOTYPE = 0;
+const uint8_t STT_FUNC = 2;
+const uint8_t STB_GLOBAL = 1;
+
+struct Elf64Ehdr {
+    uint8_t  e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint64_t e_entry;
+    uint64_t e_phoff;
+    uint64_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+};
+
+struct Elf64Phdr {
+    uint32_t p_type;
+    uint32_t p_flags;
+    uint64_t p_offset;
+    uint64_t p_vaddr;
+    uint64_t p_paddr;
+    uint64_t p_filesz;
+    uint64_t p_memsz;
+    uint64_t p_align;
+};
+
+struct Elf64Shdr {
+    uint32_t sh_name;
+    uint32_t sh_type;
+    uint64_t sh_flags;
+    uint64_t sh_addr;
+    uint64_t sh_offset;
+    uint64_t sh_size;
+    uint32_t sh_link;
+    uint32_t sh_info;
+    uint64_t sh_addralign;
+    uint64_t sh_entsize;
+};
+
+struct Elf64Sym {
+    uint32_t st_name;
+    uint8_t  st_info;
+    uint8_t  st_other;
+    uint16_t st_shndx;
+    uint64_t st_value;
+    uint64_t st_size;
+};
+
+// Символы функций и меток из первой .symtab. Без неё или при повреждённых заголовках
+// секций таблица остаётся пустой: для загрузки программы символы не нужны.
+void read_symbols(const std::vector<uint8_t>& bytes, const Elf64Ehdr& ehdr, std::vector<ElfSymbol>& symbols) {
+    symbols.clear();
+    if (ehdr.e_shoff == 0 || ehdr.e_shentsize != sizeof(Elf64Shdr) ||
+        ehdr.e_shoff + static_cast<uint64_t>(ehdr.e_shnum) * sizeof(Elf64Shdr) > bytes.size()) {
+        return;
+    }
+    auto section = [&](uint32_t index) {
+        Elf64Shdr shdr;
+        std::memcpy(&shdr, bytes.data() + ehdr.e_shoff + static_cast<uint64_t>(index) * sizeof(Elf64Shdr),
+                    sizeof(shdr));
+        return shdr;
+    };
+
+    for (uint16_t i = 0; i < ehdr.e_shnum; ++i) {
+        Elf64Shdr symtab = section(i);
+        if (symtab.sh_type != SHT_SYMTAB || symtab.sh_entsize != sizeof(Elf64Sym) || symtab.sh_link >= ehdr.e_shnum) {
+            continue;
+        }
+        Elf64Shdr strtab = section(symtab.sh_link);
+        if (symtab.sh_offset + symtab.sh_size > bytes.size() || strtab.sh_offset + strtab.sh_size > bytes.size()) {
+            return;
+        }
+        for (uint64_t pos = 0; pos + sizeof(Elf64Sym) <= symtab.sh_size; pos += sizeof(Elf64Sym)) {
+            Elf64Sym sym;
+            std::memcpy(&sym, bytes.data() + symtab.sh_offset + pos, sizeof(sym));
+            uint8_t type = sym.st_info & 0xF;
+            if ((type != STT_FUNC && type != STT_NOTYPE) || sym.st_shndx == SHN_UNDEF ||
+                sym.st_shndx >= SHN_LORESERVE || sym.st_name >= strtab.sh_size) {
+                continue;
+            }
+            const char* name = reinterpret_cast<const char*>(bytes.data() + strtab.sh_offset + sym.st_name);
+            size_t name_len = strnlen(name, strtab.sh_size - sym.st_name);
+            // $x/$d -- служебные символы разметки RISC-V, .L* -- локальные метки компилятора
+            if (name_len == 0 || name[0] == '$' || (name_len > 1 && name[0] == '.' && name[1] == 'L')) {
+                continue;
+            }
+            ElfSymbol symbol;
+            symbol.name.assign(name, name_len);
+            symbol.addr = sym.st_value;
+            symbol.size = sym.st_size;
+            symbol.global = (sym.st_info >> 4) == STB_GLOBAL;
+            symbols.push_back(std::move(symbol));
+        }
+        return;
+    }
+}
+
+} // namespace
+
+bool ElfImage::read_word(uint64_t addr, uint32_t& word) const {
+    for (const ElfSegment& segment : segments) {
+        if (addr >= segment.vaddr && addr - segment.vaddr + 4 <= segment.data.size()) {
+            std::memcpy(&word, segment.data.data() + (addr - segment.vaddr), sizeof(word));
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ElfSegment::executable() const {
+    return (flags & PF_X) != 0;
+}
+
+bool load_elf_file(const std::string& path, ElfImage& image) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open ELF file: " << path << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Elf64Ehdr ehdr;
+    if (bytes.size() < sizeof(ehdr)) {
+        std::cerr << "ERROR: File too small to be an ELF64 image: " << path << std::endl;
+        return false;
+    }
+    std::memcpy(&ehdr, bytes.data(), sizeof(ehdr));
+
+    if (std::memcmp(ehdr.e_ident, ELF_MAGIC, sizeof(ELF_MAGIC)) != 0) {
+        std::cerr << "ERROR: Not an ELF file: " << path << std::endl;
+        return false;
+    }
+    if (ehdr.e_ident[4] != ELFCLASS64 || ehdr.e_ident[5] != ELFDATA2LSB) {
+        std::cerr << "ERROR: Only little-endian ELF64 is supported: " << path << std::endl;
+        return false;
+    }
+    if (ehdr.e_machine != EM_RISCV) {
+        std::cerr << "ERROR: ELF machine is not RISC-V (" << ehdr.e_machine << "): " << path << std::endl;
+        return false;
+    }
+    if (ehdr.e_phentsize != sizeof(Elf64Phdr)) {
+        std::cerr << "ERROR: Unexpected program header size " << ehdr.e_phentsize << ": " << path << std::endl;
+        return false;
+    }
+
+    image.entry = ehdr.e_entry;
+    image.segments.clear();
+
+    for (uint16_t i = 0; i < ehdr.e_phnum; ++i) {
+        uint64_t ph_pos = ehdr.e_phoff + static_cast<uint64_t>(i) * sizeof(Elf64Phdr);
+        if (ph_pos + sizeof(Elf64Phdr) > bytes.size()) {
+            std::cerr << "ERROR: Program header " << i << " is out of file bounds: " << path << std::endl;
+            return false;
+        }
+        Elf64Phdr phdr;
+        std::memcpy(&phdr, bytes.data() + ph_pos, sizeof(phdr));
+        if (phdr.p_type != PT_LOAD || phdr.p_memsz == 0) {
+            continue;
+        }
+        if (phdr.p_offset + phdr.p_filesz > bytes.size() || phdr.p_filesz > phdr.p_memsz) {
+            std::cerr << "ERROR: Segment " << i << " is out of file bounds: " << path << std::endl;
+            return false;
+        }
+
+        ElfSegment segment;
+        segment.vaddr = phdr.p_vaddr;
+        segment.mem_size = phdr.p_memsz;
+        segment.flags = phdr.p_flags;
+        segment.data.assign(bytes.begin() + phdr.p_offset, bytes.begin() + phdr.p_offset + phdr.p_filesz);
+        image.segments.push_back(std::move(segment));
+    }
+
+    if (image.segments.empty()) {
+        std::cerr << "ERROR: No loadable segments in ELF file: " << path << std::endl;
+        return false;
+    }
+    read_symbols(bytes, ehdr, image.symbols);
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef ELF_LOADER_H
+#define ELF_LOADER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Загружаемый (PT_LOAD) сегмент ELF64: байты из файла плюс нулевой хвост до mem_size (.bss).
+struct ElfSegment {
+    uint64_t vaddr = 0;
+    uint64_t mem_size = 0;
+    uint32_t flags = 0;
+    std::vector<uint8_t> data;
+
+    bool executable() const;
+};
+
+// Символ из .symtab: функция или метка (STT_FUNC/STT_NOTYPE) в одной из секций файла.
+struct ElfSymbol {
+    std::string name;
+    uint64_t addr = 0;
+    uint64_t size = 0;     // 0 у меток ассемблера
+    bool global = false;
+};
+
+struct ElfImage {
+    uint64_t entry = 0;
+    std::vector<ElfSegment> segments;
+    std::vector<ElfSymbol> symbols;  // пусто у файла без .symtab (strip)
+
+    // 32-битное слово из загружаемых сегментов; false, если адрес вне их данных.
+    bool read_word(uint64_t addr, uint32_t& word) const;
+};
+
+// Разбирает little-endian ELF64 для RISC-V без внешних утилит (readelf/objcopy).
+// В отличие от scripts/elf_to_memh.py берёт все загружаемые сегменты, а не только .text,
+// и таблицу символов (для профиля по PC, harness/pc_profile.h).
+bool load_elf_file(const std::string& path, ElfImage& image);
+
+#endif // ELF_LOADER_H
@@ -0,0 +1,221 @@
+#include "kanata_trace.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const char* const STAGE_NAMES[] = {"F", "D", "E", "M", "W"};
+
+// Мнемоника RV64IM для подписи строки (без операндов: полное слово -- во всплывающей подсказке)
+const char* mnemonic(uint32_t instr) {
+    const uint32_t opcode = instr & 0x7F;
+    const uint32_t funct3 = (instr >> 12) & 0x7;
+    const uint32_t funct7 = instr >> 25;
+    const bool alt = (instr >> 30) & 1;   // sub/sra
+    switch (opcode) {
+    case 0x37: return "lui";
+    case 0x17: return "auipc";
+    case 0x6F: return "jal";
+    case 0x67: return "jalr";
+    case 0x63: {
+        static const char* const names[] = {"beq", "bne", "?", "?", "blt", "bge", "bltu", "bgeu"};
+        return names[funct3];
+    }
+    case 0x03: {
+        static const char* const names[] = {"lb", "lh", "lw", "ld", "lbu", "lhu", "lwu", "?"};
+        return names[funct3];
+    }
+    case 0x23: {
+        static const char* const names[] = {"sb", "sh", "sw", "sd", "?", "?", "?", "?"};
+        return names[funct3];
+    }
+    case 0x13: {
+        static const char* const names[] = {"addi", "slli", "slti", "sltiu", "xori", "srli", "ori", "andi"};
+        return (funct3 == 5 && alt) ? "srai" : names[funct3];
+    }
+    case 0x1B: {
+        static const char* const names[] = {"addiw", "slliw", "?", "?", "?", "srliw", "?", "?"};
+        return (funct3 == 5 && alt) ? "sraiw" : names[funct3];
+    }
+    case 0x33: {
+        static const char* const muldiv[] = {"mul", "mulh", "mulhsu", "mulhu", "div", "divu", "rem", "remu"};
+        static const char* const names[] = {"add", "sll", "slt", "sltu", "xor", "srl", "or", "and"};
+        if (funct7 == 1) {
+            return muldiv[funct3];
+        }
+        return (funct3 == 0 && alt) ? "sub" : (funct3 == 5 && alt) ? "sra" : names[funct3];
+    }
+    case 0x3B: {
+        static const char* const muldiv[] = {"mulw", "?", "?", "?", "divw", "divuw", "remw", "remuw"};
+        static const char* const names[] = {"addw", "sllw", "?", "?", "?", "srlw", "?", "?"};
+        if (funct7 == 1) {
+            return muldiv[funct3];
+        }
+        return (funct3 == 0 && alt) ? "subw" : (funct3 == 5 && alt) ? "sraw" : names[funct3];
+    }
+    case 0x0F: return "fence";
+    case 0x73: return "system";
+    default:   return "?";
+    }
+}
+
+} // namespace
+
+KanataTrace::KanataTrace(const TraceOptions& opts) : opts_(opts) {}
+
+KanataTrace::~KanataTrace() {
+    close();
+}
+
+bool KanataTrace::open() {
+    out_.open(opts_.kanata_file, std::ios::out | std::ios::trunc);
+    if (!out_.is_open()) {
+        std::cerr << "ERROR: Could not open Kanata log file: " << opts_.kanata_file << std::endl;
+        return false;
+    }
+    out_ << "Kanata\t0004\n";
+    return true;
+}
+
+void KanataTrace::close() {
+    if (!out_.is_open()) {
+        return;
+    }
+    out_.close();
+    std::cout << "Wrote Kanata pipeline log of " << next_id_ << " instructions to " << opts_.kanata_file << std::endl;
+}
+
+void KanataTrace::restart(const Vpipeline& top, uint64_t cycle) {
+    if (!out_.is_open()) {
+        return;
+    }
+    set_cycle(cycle);
+    for (Slot& slot : slots_) {
+        if (slot.valid) {
+            finish(slot, false);
+        }
+        slot = Slot();
+    }
+    fetch(slots_[STAGE_F], top, cycle);
+    read_controls(top);
+}
+
+void KanataTrace::sample(const Vpipeline& top, uint64_t cycle) {
+    if (!out_.is_open()) {
+        return;
+    }
+    const bool stall[NUM_STAGES] = {
+        (stall_ & 1) != 0, (stall_ & 2) != 0, (stall_ & 4) != 0, (stall_ & 8) != 0, (stall_ & 16) != 0};
+    const bool flush[NUM_STAGES] = {redirect_, (flush_ & 1) != 0, (flush_ & 2) != 0, (flush_ & 4) != 0, false};
+
+    StageBundles stages;
+    read_stage_bundles(top, stages);
+    const bool occupied[NUM_STAGES] = {true, stages.if_id.pc_4 != 0, stages.id_ex.pc_4 != 0,
+                                       stages.ex_mem.pc_4 != 0, stages.mem_wb.pc_4 != 0};
+
+    set_cycle(cycle);
+
+    // Стадия держит инструкцию (stall без flush) или принимает её из предыдущей;
+    // инструкция, которая не осталась и не перешла дальше, сброшена или завершена
+    Slot next[NUM_STAGES];
+    bool moved[NUM_STAGES] = {};
+    for (int s = NUM_STAGES - 1; s >= 0; --s) {
+        const bool keep = stall[s] && !flush[s];
+        if (keep) {
+            next[s] = slots_[s];
+        } else if (s > STAGE_F && !flush[s]) {
+            next[s] = slots_[s - 1];
+            moved[s - 1] = true;
+        }
+        // Пузырь в регистре стадии: то, что туда шло, сброшено (сверка с RTL)
+        if (!occupied[s] && next[s].valid) {
+            if (keep) {
+                finish(slots_[s], false);
+            } else {
+                moved[s - 1] = false;
+            }
+            next[s] = Slot();
+        }
+        if (!keep && slots_[s].valid && !moved[s]) {
+            finish(slots_[s], s == STAGE_W);
+        }
+    }
+
+    for (int s = STAGE_D; s < NUM_STAGES; ++s) {
+        if (next[s].valid && moved[s - 1]) {
+            start_stage(next[s], static_cast<Stage>(s));
+            if (s == STAGE_D) {
+                label_decode(next[s], stages.if_id);
+            }
+        }
+    }
+    if (!(stall[STAGE_F] && !flush[STAGE_F])) {
+        fetch(next[STAGE_F], top, cycle);
+    }
+
+    for (int s = 0; s < NUM_STAGES; ++s) {
+        slots_[s] = next[s];
+    }
+    read_controls(top);
+}
+
+void KanataTrace::read_controls(const Vpipeline& top) {
+    stall_ = top.stall_o;
+    flush_ = top.flush_o;
+    redirect_ = top.redirect_o != 0;
+}
+
+void KanataTrace::fetch(Slot& slot, const Vpipeline& top, uint64_t cycle) {
+    slot = Slot();
+    slot.valid = true;
+    slot.logged = cycle >= opts_.start_cycle && cycle <= opts_.stop_cycle;
+    if (!slot.logged) {
+        return;
+    }
+    slot.id = next_id_++;
+    out_ << "I\t" << slot.id << "\t" << slot.id << "\t0\n"
+         << "L\t" << slot.id << "\t0\t" << std::hex << std::setw(8) << std::setfill('0') << top.pc_f_o
+         << std::setfill(' ') << std::dec << ": \n";
+    start_stage(slot, STAGE_F);
+}
+
+void KanataTrace::label_decode(const Slot& slot, const IfIdBundle& if_id) {
+    if (!slot.logged) {
+        return;
+    }
+    out_ << "L\t" << slot.id << "\t0\t" << mnemonic(if_id.instr);
+    if (if_id.fused) {
+        out_ << " + " << mnemonic(if_id.instr2);
+    }
+    out_ << "\nL\t" << slot.id << "\t1\t" << std::hex << std::setfill('0') << "instr 0x" << std::setw(8)
+         << if_id.instr;
+    if (if_id.fused) {
+        out_ << " + 0x" << std::setw(8) << if_id.instr2;
+    }
+    out_ << std::setfill(' ') << std::dec << "\n";
+}
+
+void KanataTrace::set_cycle(uint64_t cycle) {
+    if (!cycle_written_) {
+        out_ << "C=\t" << cycle << "\n";
+        cycle_written_ = true;
+    } else if (cycle > file_cycle_) {
+        out_ << "C\t" << (cycle - file_cycle_) << "\n";
+    }
+    file_cycle_ = cycle;
+}
+
+void KanataTrace::start_stage(const Slot& slot, Stage stage) {
+    if (slot.logged) {
+        out_ << "S\t" << slot.id << "\t0\t" << STAGE_NAMES[stage] << "\n";
+    }
+}
+
+void KanataTrace::finish(const Slot& slot, bool retired) {
+    if (!slot.logged) {
+        return;
+    }
+    // Тип 0 -- завершение (номер в порядке завершения), 1 -- сброс
+    out_ << "R\t" << slot.id << "\t" << (retired ? next_retire_id_++ : 0) << "\t" << (retired ? 0 : 1) << "\n";
+}
@@ -0,0 +1,66 @@
+#ifndef KANATA_TRACE_H
+#define KANATA_TRACE_H
+
+#include "Vpipeline.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "sim_options.h"
+#include "stage_bundles.h"
+
+// Журнал конвейера в формате Kanata (версия 0004) для просмотрщика Konata:
+// каждая выбранная инструкция получает номер и прослеживается по стадиям F, D, E, M, W
+// до завершения или сброса. Куда инструкции переходят на фронте, берётся из портов
+// stall_o/flush_o/redirect_o (сигналы hazard_unit), а пузыри -- из stage_bundles.
+// Второй слот DUAL_ISSUE отдельной строкой не показывается: он идёт рядом с первым.
+// Слитая пара (MACRO_FUSION) -- одна строка с обеими командами в подписи.
+class KanataTrace {
+public:
+    explicit KanataTrace(const TraceOptions& opts);
+    ~KanataTrace();
+
+    KanataTrace(const KanataTrace&) = delete;
+    KanataTrace& operator=(const KanataTrace&) = delete;
+
+    bool open();
+    void close();
+
+    // Начало отсчёта после сброса или восстановления контрольной точки: инструкции,
+    // которые были в конвейере, считаются сброшенными, выборка начинается заново.
+    void restart(const Vpipeline& top, uint64_t cycle);
+
+    // После каждого такта вне сброса; cycle -- номер такта, который начался.
+    void sample(const Vpipeline& top, uint64_t cycle);
+
+private:
+    enum Stage { STAGE_F = 0, STAGE_D, STAGE_E, STAGE_M, STAGE_W, NUM_STAGES };
+
+    struct Slot {
+        bool valid = false;
+        bool logged = false;   // выбрана в окне --trace-start/--trace-stop
+        uint64_t id = 0;       // номер в файле (команда I), только у logged
+    };
+
+    void read_controls(const Vpipeline& top);
+    void fetch(Slot& slot, const Vpipeline& top, uint64_t cycle);
+    void set_cycle(uint64_t cycle);
+    void start_stage(const Slot& slot, Stage stage);
+    void finish(const Slot& slot, bool retired);
+    void label_decode(const Slot& slot, const IfIdBundle& if_id);
+
+    TraceOptions opts_;
+    std::ofstream out_;
+    Slot slots_[NUM_STAGES];
+    // stall_o/flush_o/redirect_o предыдущего такта: они решают, куда стадии перешли на фронте
+    uint8_t stall_ = 0;
+    uint8_t flush_ = 0;
+    bool redirect_ = false;
+    uint64_t next_id_ = 0;
+    uint64_t next_retire_id_ = 0;
+    uint64_t file_cycle_ = 0;
+    bool cycle_written_ = false;
+};
+
+#endif // KANATA_TRACE_H
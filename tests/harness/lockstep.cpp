@@ -0,0 +1,116 @@
+#include "lockstep.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+// Ограничение на число инструкций эталона без записи в регистр между двумя записями RTL
+const uint64_t MAX_REF_STEPS_WITHOUT_WRITE = 1ULL << 20;
+
+} // namespace
+
+LockstepChecker::LockstepChecker(RefHart& ref, size_t history_size)
+    : ref_(ref), history_size_(history_size) {}
+
+bool LockstepChecker::next_ref_write(RetireInfo& info) {
+    for (uint64_t steps = 0; steps < MAX_REF_STEPS_WITHOUT_WRITE; ++steps) {
+        RefHart::StepResult result = ref_.step(info);
+        if (result != RefHart::StepResult::Ok) {
+            ref_halted_ = true;
+            halt_reason_ = result;
+            return false;
+        }
+        if (info.rd_written) {
+            return true;
+        }
+    }
+    std::cerr << "LOCKSTEP: reference executed " << MAX_REF_STEPS_WITHOUT_WRITE
+              << " instructions without a register write" << std::endl;
+    return false;
+}
+
+bool LockstepChecker::on_rtl_write(uint64_t cycle, uint64_t pc, uint8_t rd, uint64_t value, bool fused) {
+    Commit rtl = {cycle, pc, rd, value};
+
+    RetireInfo ref;
+    if (ref_halted_ || !next_ref_write(ref)) {
+        print_context(&rtl, nullptr);
+        return false;
+    }
+    if (fused && ref.pc == pc && ref_.pc() == pc + 4) {
+        RetireInfo second;
+        RefHart::StepResult result = ref_.step(second);
+        if (result != RefHart::StepResult::Ok) {
+            ref_halted_ = true;
+            halt_reason_ = result;
+            print_context(&rtl, nullptr);
+            return false;
+        }
+        if (second.rd_written) {
+            ref.rd = second.rd;
+            ref.rd_value = second.rd_value;
+        }
+    }
+    if (ref.pc != pc || ref.rd != rd || ref.rd_value != value) {
+        print_context(&rtl, &ref);
+        return false;
+    }
+
+    commits_checked_++;
+    history_.push_back(rtl);
+    if (history_.size() > history_size_) {
+        history_.pop_front();
+    }
+    return true;
+}
+
+bool LockstepChecker::on_rtl_halt(uint64_t cycle, uint64_t pc) {
+    RetireInfo ref;
+    if (!ref_halted_ && next_ref_write(ref)) {
+        std::cerr << "\nLOCKSTEP: RTL halted at pc 0x" << std::hex << pc << std::dec << " (cycle " << cycle
+                  << "), but the reference still writes registers" << std::endl;
+        print_context(nullptr, &ref);
+        return false;
+    }
+    if (!ref_halted_ || halt_reason_ != RefHart::StepResult::Halt || ref_.pc() != pc) {
+        std::cerr << "\nLOCKSTEP: RTL halted at pc 0x" << std::hex << pc << ", reference stopped at pc 0x"
+                  << ref_.pc() << std::dec
+                  << (halt_reason_ == RefHart::StepResult::IllegalInstr ? " on an illegal instruction" : "")
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void LockstepChecker::print_context(const Commit* rtl, const RetireInfo* ref) const {
+    std::ostream& out = std::cerr;
+    out << std::hex << std::setfill('0');
+    out << "\nLOCKSTEP MISMATCH after " << std::dec << commits_checked_ << std::hex << " matching commits\n";
+    out << "  Last matching commits (cycle | pc | rd | value):\n";
+    for (const Commit& c : history_) {
+        out << "    " << std::dec << std::setw(8) << std::setfill(' ') << c.cycle << std::hex << std::setfill('0')
+            << " | 0x" << std::setw(8) << c.pc << " | x" << std::dec << static_cast<int>(c.rd) << std::hex
+            << " | 0x" << std::setw(16) << c.value << "\n";
+    }
+    if (rtl) {
+        out << "  RTL:       cycle " << std::dec << rtl->cycle << std::hex << ", pc 0x" << std::setw(8) << rtl->pc
+            << ", x" << std::dec << static_cast<int>(rtl->rd) << std::hex << " <= 0x" << std::setw(16) << rtl->value
+            << "\n";
+    }
+    if (ref) {
+        out << "  Reference: pc 0x" << std::setw(8) << ref->pc << " (instr 0x" << std::setw(8) << ref->instr
+            << "), x" << std::dec << static_cast<int>(ref->rd) << std::hex << " <= 0x" << std::setw(16)
+            << ref->rd_value << "\n";
+    } else if (ref_halted_) {
+        out << "  Reference: "
+            << (halt_reason_ == RefHart::StepResult::Halt ? "halted" : "illegal instruction")
+            << " at pc 0x" << std::setw(8) << ref_.pc() << ", but the RTL kept writing registers\n";
+    }
+    out << "  Reference register file:\n";
+    for (unsigned i = 0; i < 32; ++i) {
+        out << (i % 4 == 0 ? "    " : "  ") << "x" << std::dec << std::setw(2) << std::setfill(' ') << i
+            << std::hex << std::setfill('0') << " = 0x" << std::setw(16) << ref_.reg(i) << (i % 4 == 3 ? "\n" : "");
+    }
+    out << std::dec << std::setfill(' ') << std::flush;
+}
@@ -0,0 +1,47 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include <cstdint>
+#include <deque>
+
+#include "ref_hart.h"
+
+// Пошаговая сверка записей в регистры Vpipeline с эталонной моделью в том же процессе.
+// На каждую запись RTL (rd != x0) эталон выполняет инструкции до своей следующей записи
+// в регистр; первое расхождение печатается с контекстом, и прогон можно сразу остановить.
+class LockstepChecker {
+public:
+    explicit LockstepChecker(RefHart& ref, size_t history_size = 16);
+
+    // false -- расхождение (или эталон остановился раньше RTL).
+    // fused: слитая пара (MACRO_FUSION) -- эталон выполняет и команду pc + 4,
+    // сверяется последняя запись пары.
+    bool on_rtl_write(uint64_t cycle, uint64_t pc, uint8_t rd, uint64_t value, bool fused = false);
+
+    // RTL остановился на инструкции SYSTEM по адресу pc: эталон должен дойти до неё же,
+    // не записав больше ни одного регистра.
+    bool on_rtl_halt(uint64_t cycle, uint64_t pc);
+
+    uint64_t commits_checked() const { return commits_checked_; }
+    bool ref_halted() const { return ref_halted_; }
+
+private:
+    struct Commit {
+        uint64_t cycle;
+        uint64_t pc;
+        uint8_t rd;
+        uint64_t value;
+    };
+
+    bool next_ref_write(RetireInfo& info);
+    void print_context(const Commit* rtl, const RetireInfo* ref) const;
+
+    RefHart& ref_;
+    size_t history_size_;
+    std::deque<Commit> history_;
+    uint64_t commits_checked_ = 0;
+    bool ref_halted_ = false;
+    RefHart::StepResult halt_reason_ = RefHart::StepResult::Ok;
+};
+
+#endif // LOCKSTEP_H
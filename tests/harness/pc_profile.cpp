@@ -0,0 +1,320 @@
+#include "pc_profile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+const size_t NO_SYMBOL = SIZE_MAX;
+
+// Ключ (стек, PC) в stack_cycles_: адреса программ модели умещаются в 48 бит
+const unsigned STACK_ID_SHIFT = 48;
+const uint64_t STACK_PC_MASK = (1ULL << STACK_ID_SHIFT) - 1;
+
+// Глубже теневой стек не растёт (рекурсия); лишние вызовы только считаются,
+// чтобы возвраты из них не снимали настоящие кадры
+const size_t MAX_STACK_DEPTH = 256;
+
+const uint32_t OPCODE_JAL = 0x6F;
+const uint32_t OPCODE_JALR = 0x67;
+
+bool is_link_reg(uint32_t reg) {
+    return reg == 1 || reg == 5;
+}
+
+// PC самой старой инструкции в конвейере; пузырь в стадии виден как pc_4 == 0
+uint64_t oldest_pc(const StageBundles& s, uint64_t pc_f) {
+    if (s.mem_wb.pc_4 != 0) {
+        return s.mem_wb.pc_4 - (s.mem_wb.fused ? 8 : 4);
+    }
+    if (s.ex_mem.pc_4 != 0) {
+        return s.ex_mem.pc_4 - (s.ex_mem.fused ? 8 : 4);
+    }
+    if (s.id_ex.pc_4 != 0) {
+        return s.id_ex.pc;
+    }
+    if (s.if_id.pc_4 != 0) {
+        return s.if_id.pc;
+    }
+    return pc_f;
+}
+
+double percent(uint64_t part, uint64_t whole) {
+    return whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+}
+
+} // namespace
+
+PcProfiler::PcProfiler(const ProfileOptions& opts, const PerfCounters& perf) : opts_(opts), perf_(perf) {}
+
+void PcProfiler::restart(const Vpipeline& top, const ElfImage& image) {
+    image_ = &image;
+    symbols_.clear();
+    for (const ElfSymbol& symbol : image.symbols) {
+        for (const ElfSegment& segment : image.segments) {
+            if (segment.executable() && symbol.addr >= segment.vaddr &&
+                symbol.addr - segment.vaddr < segment.mem_size) {
+                symbols_.push_back(symbol);
+                break;
+            }
+        }
+    }
+    // На одном адресе остаётся один символ, глобальный раньше локальной метки
+    std::sort(symbols_.begin(), symbols_.end(), [](const ElfSymbol& a, const ElfSymbol& b) {
+        if (a.addr != b.addr) {
+            return a.addr < b.addr;
+        }
+        return a.global != b.global ? a.global : a.name < b.name;
+    });
+    symbols_.erase(std::unique(symbols_.begin(), symbols_.end(),
+                               [](const ElfSymbol& a, const ElfSymbol& b) { return a.addr == b.addr; }),
+                   symbols_.end());
+
+    if (stack_names_.empty()) {
+        stack_names_.push_back("");
+        stack_ids_[""] = 0;
+    }
+    // Прогон начинается заново (или с перенесённого состояния): прежние вызовы неизвестны
+    stack_.clear();
+    read_state(top, prev_);
+    counters_ = read_counters();
+}
+
+void PcProfiler::read_state(const Vpipeline& top, StageState& state) const {
+    read_stage_bundles(top, state.stages);
+    state.pc_f = top.pc_f_o;
+    state.pc_w2 = top.pc_w2_o;
+}
+
+PcProfiler::Counters PcProfiler::read_counters() const {
+    Counters counters;
+    counters.instret = perf_.read(PERF_INSTRET);
+    counters.load_use = perf_.read(PERF_LOAD_USE_STALL);
+    counters.flush = perf_.read(PERF_BRANCH_FLUSH) + perf_.read(PERF_JUMP_FLUSH);
+    return counters;
+}
+
+void PcProfiler::sample(const Vpipeline& top) {
+    StageState state;
+    read_state(top, state);
+    Counters counters = read_counters();
+    const StageBundles& s = prev_.stages;
+
+    // Приращения за такт относятся к стадиям до фронта, то есть к prev_
+    total_cycles_++;
+    const uint64_t head = oldest_pc(s, prev_.pc_f);
+    stats_[head].cycles++;
+    const uint32_t stack_id = stack_.empty() ? 0 : stack_.back();
+    stack_cycles_[(static_cast<uint64_t>(stack_id) << STACK_ID_SHIFT) | (head & STACK_PC_MASK)]++;
+
+    if (counters.load_use != counters_.load_use && s.if_id.pc_4 != 0) {
+        stats_[s.if_id.pc].load_use++;
+    }
+    if (counters.flush != counters_.flush) {
+        // Execute сбрасывает и себя (FlushE): после фронта там пузырь. Переход из
+        // Decode (EARLY_BRANCH) сам уходит в Execute, сбрасывается только выборка.
+        const bool from_execute = s.id_ex.pc_4 != 0 && (s.id_ex.branch || s.id_ex.jump) &&
+                                  state.stages.id_ex.pc_4 == 0;
+        if (from_execute) {
+            stats_[s.id_ex.pc].flush += 2;
+        } else if (s.if_id.pc_4 != 0) {
+            stats_[s.if_id.pc].flush += 1;
+        }
+    }
+
+    // Завершённые инструкции в программном порядке: первый слот, вторая команда
+    // слитой пары, второй слот выдачи
+    uint64_t retired = counters.instret - counters_.instret;
+    if (retired != 0 && s.mem_wb.pc_4 != 0) {
+        const uint64_t pc_w = s.mem_wb.pc_4 - (s.mem_wb.fused ? 8 : 4);
+        retire(pc_w);
+        retired--;
+        if (s.mem_wb.fused && retired != 0) {
+            retire(pc_w + 4);
+            retired--;
+        }
+    }
+    if (retired != 0) {
+        retire(prev_.pc_w2);
+    }
+
+    counters_ = counters;
+    prev_ = state;
+}
+
+void PcProfiler::retire(uint64_t pc) {
+    stats_[pc].retired++;
+
+    uint32_t instr = 0;
+    if (!image_ || !image_->read_word(pc, instr)) {
+        return;
+    }
+    const uint32_t opcode = instr & 0x7F;
+    const uint32_t rd = (instr >> 7) & 0x1F;
+    const uint32_t rs1 = (instr >> 15) & 0x1F;
+    const uint32_t imm = instr >> 20;
+    if ((opcode == OPCODE_JAL || opcode == OPCODE_JALR) && is_link_reg(rd)) {
+        push_frame(pc);
+    } else if (opcode == OPCODE_JALR && rd == 0 && is_link_reg(rs1) && imm == 0 && !stack_.empty()) {
+        stack_.pop_back();
+    }
+}
+
+void PcProfiler::push_frame(uint64_t pc) {
+    if (stack_.size() >= MAX_STACK_DEPTH) {
+        stack_.push_back(stack_.back());
+        return;
+    }
+    const uint32_t parent = stack_.empty() ? 0 : stack_.back();
+    std::string name = stack_names_[parent];
+    if (!name.empty()) {
+        name += ';';
+    }
+    name += symbolize(pc, false);
+
+    auto it = stack_ids_.find(name);
+    if (it == stack_ids_.end()) {
+        it = stack_ids_.emplace(name, static_cast<uint32_t>(stack_names_.size())).first;
+        stack_names_.push_back(name);
+    }
+    stack_.push_back(it->second);
+}
+
+size_t PcProfiler::symbol_index(uint64_t pc) const {
+    auto it = std::upper_bound(symbols_.begin(), symbols_.end(), pc,
+                               [](uint64_t addr, const ElfSymbol& symbol) { return addr < symbol.addr; });
+    if (it == symbols_.begin()) {
+        return NO_SYMBOL;
+    }
+    --it;
+    // У функций с размером адрес за её концом ей не принадлежит
+    if (it->size != 0 && pc - it->addr >= it->size) {
+        return NO_SYMBOL;
+    }
+    return static_cast<size_t>(it - symbols_.begin());
+}
+
+std::string PcProfiler::symbolize(uint64_t pc, bool with_offset) const {
+    std::ostringstream out;
+    size_t index = symbol_index(pc);
+    if (index == NO_SYMBOL) {
+        out << "0x" << std::hex << pc;
+        return out.str();
+    }
+    const ElfSymbol& symbol = symbols_[index];
+    out << symbol.name;
+    if (with_offset && pc != symbol.addr) {
+        out << "+0x" << std::hex << (pc - symbol.addr);
+    }
+    return out.str();
+}
+
+bool PcProfiler::write_reports(const std::string& test_name) const {
+    bool ok = true;
+    if (!opts_.report_file.empty()) {
+        ok = write_report(opts_.report_file, test_name) && ok;
+    }
+    if (!opts_.folded_file.empty()) {
+        ok = write_folded(opts_.folded_file) && ok;
+    }
+    return ok;
+}
+
+bool PcProfiler::write_report(const std::string& path, const std::string& test_name) const {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open profile report file: " << path << std::endl;
+        return false;
+    }
+
+    PcStats total;
+    std::map<std::string, PcStats> by_symbol;
+    std::vector<std::pair<uint64_t, PcStats>> by_pc(stats_.begin(), stats_.end());
+    for (const auto& entry : by_pc) {
+        PcStats& symbol = by_symbol[symbolize(entry.first, false)];
+        symbol.cycles += entry.second.cycles;
+        symbol.retired += entry.second.retired;
+        symbol.load_use += entry.second.load_use;
+        symbol.flush += entry.second.flush;
+        total.retired += entry.second.retired;
+        total.load_use += entry.second.load_use;
+        total.flush += entry.second.flush;
+    }
+
+    out << "PROFILE: " << test_name << ": " << total_cycles_ << " cycles, " << total.retired
+        << " instructions retired, " << total.load_use << " load-use stall cycles, " << total.flush
+        << " flush cycles\n"
+        << "cycles:   charged to the oldest instruction in the pipeline (Writeback first)\n"
+        << "load_use: cycles the instruction waited in Decode for a load result\n"
+        << "flush:    fetch cycles lost to a redirect by this branch or jump\n";
+
+    auto print_header = [&](const char* title, const char* location) {
+        out << "\n" << title << "\n"
+            << std::setw(12) << "cycles" << std::setw(8) << "%" << std::setw(12) << "retired"
+            << std::setw(10) << "load_use" << std::setw(10) << "flush" << "  " << location << "\n";
+    };
+    auto print_row = [&](const PcStats& stats) {
+        out << std::setw(12) << stats.cycles << std::setw(8) << std::fixed << std::setprecision(2)
+            << percent(stats.cycles, total_cycles_) << std::setw(12) << stats.retired << std::setw(10)
+            << stats.load_use << std::setw(10) << stats.flush << "  ";
+    };
+
+    std::vector<std::pair<std::string, PcStats>> symbols(by_symbol.begin(), by_symbol.end());
+    std::stable_sort(symbols.begin(), symbols.end(), [](const auto& a, const auto& b) {
+        return a.second.cycles > b.second.cycles;
+    });
+    print_header("By symbol:", "symbol");
+    for (const auto& entry : symbols) {
+        print_row(entry.second);
+        out << entry.first << "\n";
+    }
+
+    std::sort(by_pc.begin(), by_pc.end(), [](const auto& a, const auto& b) {
+        return a.second.cycles != b.second.cycles ? a.second.cycles > b.second.cycles : a.first < b.first;
+    });
+    print_header("By PC:", "pc  location");
+    for (const auto& entry : by_pc) {
+        print_row(entry.second);
+        out << "0x" << std::hex << std::setw(8) << std::setfill('0') << entry.first << std::dec
+            << std::setfill(' ') << "  " << symbolize(entry.first, true) << "\n";
+    }
+
+    if (!out) {
+        std::cerr << "ERROR: Failed to write profile report: " << path << std::endl;
+        return false;
+    }
+    std::cout << "Wrote PC profile of " << by_pc.size() << " addresses to " << path << std::endl;
+    return true;
+}
+
+// Формат collapsed stacks: "вызывающая;...;функция такты" -- строки с одинаковым
+// стеком (разные PC одной функции) складываются.
+bool PcProfiler::write_folded(const std::string& path) const {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open folded stacks file: " << path << std::endl;
+        return false;
+    }
+
+    std::map<std::string, uint64_t> folded;
+    for (const auto& entry : stack_cycles_) {
+        const std::string& stack = stack_names_[entry.first >> STACK_ID_SHIFT];
+        const std::string leaf = symbolize(entry.first & STACK_PC_MASK, false);
+        folded[stack.empty() ? leaf : stack + ";" + leaf] += entry.second;
+    }
+    for (const auto& entry : folded) {
+        out << entry.first << " " << entry.second << "\n";
+    }
+
+    if (!out) {
+        std::cerr << "ERROR: Failed to write folded stacks: " << path << std::endl;
+        return false;
+    }
+    std::cout << "Wrote " << folded.size() << " folded stacks to " << path << std::endl;
+    return true;
+}
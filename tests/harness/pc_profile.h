@@ -0,0 +1,90 @@
+#ifndef PC_PROFILE_H
+#define PC_PROFILE_H
+
+#include "Vpipeline.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "elf_loader.h"
+#include "perf_counters.h"
+#include "sim_options.h"
+#include "stage_bundles.h"
+
+// Профиль по PC (--profile/--profile-folded). После каждого такта приращения счётчиков
+// perf_counters относятся к инструкциям, которые в этом такте были в стадиях:
+//   cycles   -- такт целиком достаётся самой старой инструкции в конвейере (Writeback,
+//               а если там пузырь -- Memory, Execute, Decode, иначе PC выборки);
+//   retired  -- завершённые инструкции (вторая команда слитой пары -- по pc + 4,
+//               второй слот DUAL_ISSUE -- по своему PC);
+//   load_use -- такты, которые инструкция в Decode ждала результат загрузки;
+//   flush    -- такты выборки, потерянные из-за перенаправления этим переходом:
+//               2 при разрешении в Execute, 1 в Decode (EARLY_BRANCH).
+// PC отображаются на символы ELF. Для свёрнутых стеков ведётся теневой стек вызовов
+// по завершённым jal/jalr с rd = ra/t0 и возвратам jalr x0, 0(ra/t0).
+class PcProfiler {
+public:
+    PcProfiler(const ProfileOptions& opts, const PerfCounters& perf);
+
+    // Начало отсчёта: после сброса (счётчики обнулены) или восстановления контрольной
+    // точки. Накопленный профиль сохраняется. image -- программа для символов и стека.
+    void restart(const Vpipeline& top, const ElfImage& image);
+
+    // После каждого такта вне сброса.
+    void sample(const Vpipeline& top);
+
+    // Пишет отчёты в файлы из ProfileOptions.
+    bool write_reports(const std::string& test_name) const;
+
+private:
+    struct PcStats {
+        uint64_t cycles = 0;
+        uint64_t retired = 0;
+        uint64_t load_use = 0;
+        uint64_t flush = 0;
+    };
+
+    // Состояние стадий на такте, к которому относятся приращения счётчиков
+    struct StageState {
+        StageBundles stages;
+        uint64_t pc_f = 0;
+        uint64_t pc_w2 = 0;
+    };
+
+    struct Counters {
+        uint64_t instret = 0;
+        uint64_t load_use = 0;
+        uint64_t flush = 0;
+    };
+
+    void read_state(const Vpipeline& top, StageState& state) const;
+    Counters read_counters() const;
+    void retire(uint64_t pc);
+    void push_frame(uint64_t pc);
+    size_t symbol_index(uint64_t pc) const;
+    std::string symbolize(uint64_t pc, bool with_offset) const;
+    bool write_report(const std::string& path, const std::string& test_name) const;
+    bool write_folded(const std::string& path) const;
+
+    ProfileOptions opts_;
+    const PerfCounters& perf_;
+    const ElfImage* image_ = nullptr;
+    std::vector<ElfSymbol> symbols_;   // функции и метки исполняемых сегментов, по адресу
+
+    StageState prev_;
+    Counters counters_;
+    uint64_t total_cycles_ = 0;
+    std::unordered_map<uint64_t, PcStats> stats_;
+
+    // Теневой стек: id свёрнутой строки вызывающих функций, "" -- вершина программы.
+    // Строки стеков хранятся один раз, такты копятся по паре (стек, PC).
+    std::vector<uint32_t> stack_;
+    std::vector<std::string> stack_names_;
+    std::unordered_map<std::string, uint32_t> stack_ids_;
+    std::unordered_map<uint64_t, uint64_t> stack_cycles_;   // (id << 48) | pc -> такты
+};
+
+#endif // PC_PROFILE_H
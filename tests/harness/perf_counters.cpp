@@ -0,0 +1,142 @@
+#include "perf_counters.h"
+
+#include "Vpipeline__Dpi.h"
+
+#include <iomanip>
+#include <iostream>
+
+namespace {
+
+const char* const PERF_COUNTER_NAMES[PERF_NUM_COUNTERS] = {
+    "cycles",
+    "instret",
+    "load_use_stalls",
+    "branch_flushes",
+    "jump_flushes",
+    "fwd_a_from_w",
+    "fwd_a_from_m",
+    "fwd_b_from_w",
+    "fwd_b_from_m",
+    "branches",
+    "jumps",
+    "icache_hits",
+    "icache_misses",
+    "icache_evictions",
+    "icache_stall_cycles",
+    "dcache_hits",
+    "dcache_misses",
+    "dcache_evictions",
+    "dcache_stall_cycles",
+    "muldiv",
+    "div_stall_cycles",
+    "branch_stalls",
+    "dual_issued",
+    "fused_pairs",
+};
+
+double per_instr(uint64_t count, uint64_t instret) {
+    return instret ? static_cast<double>(count) / instret : 0.0;
+}
+
+double percent(uint64_t part, uint64_t total) {
+    return total ? 100.0 * part / total : 0.0;
+}
+
+} // namespace
+
+const char* perf_counter_name(unsigned index) {
+    return index < PERF_NUM_COUNTERS ? PERF_COUNTER_NAMES[index] : "unknown";
+}
+
+double PerfSnapshot::cpi() const {
+    return values[PERF_INSTRET] ? static_cast<double>(values[PERF_CYCLES]) / values[PERF_INSTRET] : 0.0;
+}
+
+PerfCounters::PerfCounters() : scope_(svGetScopeFromName(PERF_COUNTERS_SCOPE)) {
+    if (!scope_) {
+        std::cerr << "ERROR: DPI scope not found: " << PERF_COUNTERS_SCOPE << std::endl;
+        return;
+    }
+    svSetScope(scope_);
+    if (perf_dpi_count() != PERF_NUM_COUNTERS) {
+        std::cerr << "ERROR: perf_counters has " << perf_dpi_count() << " counters, harness expects "
+                  << PERF_NUM_COUNTERS << std::endl;
+        scope_ = nullptr;
+    }
+}
+
+bool PerfCounters::read(PerfSnapshot& snapshot) const {
+    if (!scope_) {
+        return false;
+    }
+    svSetScope(scope_);
+    for (unsigned i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        snapshot.values[i] = perf_dpi_read(static_cast<int>(i));
+    }
+    return true;
+}
+
+uint64_t PerfCounters::read(PerfCounter counter) const {
+    if (!scope_) {
+        return 0;
+    }
+    svSetScope(scope_);
+    return perf_dpi_read(static_cast<int>(counter));
+}
+
+void print_perf_summary(std::ostream& out, const PerfSnapshot& s) {
+    const uint64_t instret = s[PERF_INSTRET];
+    out << "PERF: " << s[PERF_CYCLES] << " cycles, " << instret << " instructions, CPI "
+        << std::fixed << std::setprecision(3) << s.cpi() << "\n"
+        << "PERF: load-use stalls " << s[PERF_LOAD_USE_STALL]
+        << " (" << per_instr(s[PERF_LOAD_USE_STALL], instret) << "/instr), branch flushes "
+        << s[PERF_BRANCH_FLUSH] << " (" << per_instr(s[PERF_BRANCH_FLUSH], instret) << "/instr), jump flushes "
+        << s[PERF_JUMP_FLUSH] << " (" << per_instr(s[PERF_JUMP_FLUSH], instret) << "/instr)\n"
+        << "PERF: branches " << s[PERF_BRANCHES] << ", " << std::setprecision(1)
+        << percent(s[PERF_BRANCH_FLUSH], s[PERF_BRANCHES]) << "% redirected; jumps " << s[PERF_JUMPS] << ", "
+        << percent(s[PERF_JUMP_FLUSH], s[PERF_JUMPS]) << "% redirected; operand stalls in Decode "
+        << s[PERF_BRANCH_STALL] << std::setprecision(3) << "\n"
+        << "PERF: forwarding A: W->E " << s[PERF_FWD_A_FROM_W] << ", M->E " << s[PERF_FWD_A_FROM_M]
+        << "; B: W->E " << s[PERF_FWD_B_FROM_W] << ", M->E " << s[PERF_FWD_B_FROM_M] << "\n";
+    // Без кэшей (ICACHE/DCACHE = 0) их счётчики нулевые, строки не печатаются
+    const char* const cache_names[] = {"I$", "D$"};
+    const unsigned cache_first[] = {PERF_ICACHE_HITS, PERF_DCACHE_HITS};
+    for (unsigned c = 0; c < 2; ++c) {
+        const uint64_t hits = s[cache_first[c]];
+        const uint64_t misses = s[cache_first[c] + 1];
+        if (hits + misses == 0) {
+            continue;
+        }
+        out << "PERF: " << cache_names[c] << " " << hits << " hits, " << misses << " misses ("
+            << std::setprecision(2) << percent(misses, hits + misses) << "%), " << s[cache_first[c] + 2]
+            << " evictions, " << s[cache_first[c] + 3] << " stall cycles" << std::setprecision(3) << "\n";
+    }
+    if (s[PERF_MULDIV] != 0) {
+        out << "PERF: mul/div " << s[PERF_MULDIV] << " (" << per_instr(s[PERF_MULDIV], instret)
+            << "/instr), divider stall cycles " << s[PERF_DIV_STALL] << "\n";
+    }
+    if (s[PERF_FUSED] != 0) {
+        out << "PERF: fused pairs " << s[PERF_FUSED] << " (" << std::setprecision(1)
+            << percent(2 * s[PERF_FUSED], instret) << "% of instructions)" << std::setprecision(3) << "\n";
+    }
+    if (s[PERF_DUAL_ISSUE] != 0) {
+        out << "PERF: dual-issued " << s[PERF_DUAL_ISSUE] << " (" << std::setprecision(1)
+            << percent(s[PERF_DUAL_ISSUE], instret) << "% of instructions), IPC " << std::setprecision(3)
+            << (s[PERF_CYCLES] ? static_cast<double>(instret) / s[PERF_CYCLES] : 0.0) << "\n";
+    }
+    out << std::defaultfloat << std::flush;
+}
+
+void write_perf_csv_header(std::ostream& out) {
+    for (unsigned i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        out << (i ? "," : "") << PERF_COUNTER_NAMES[i];
+    }
+    out << "\n";
+}
+
+void write_perf_csv_row(std::ostream& out, const PerfSnapshot& snapshot) {
+    for (unsigned i = 0; i < PERF_NUM_COUNTERS; ++i) {
+        out << (i ? "," : "") << snapshot.values[i];
+    }
+    out << "\n";
+}
@@ -0,0 +1,76 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include "svdpi.h"
+
+#include <cstdint>
+#include <ostream>
+
+// Иерархическое имя экземпляра perf_counters внутри Vpipeline
+#define PERF_COUNTERS_SCOPE "TOP.pipeline.perf_counters_inst"
+
+// Индексы совпадают с rtl/common/perf_defines.svh
+enum PerfCounter : unsigned {
+    PERF_CYCLES = 0,
+    PERF_INSTRET,
+    PERF_LOAD_USE_STALL,
+    PERF_BRANCH_FLUSH,
+    PERF_JUMP_FLUSH,
+    PERF_FWD_A_FROM_W,
+    PERF_FWD_A_FROM_M,
+    PERF_FWD_B_FROM_W,
+    PERF_FWD_B_FROM_M,
+    PERF_BRANCHES,
+    PERF_JUMPS,
+    PERF_ICACHE_HITS,
+    PERF_ICACHE_MISSES,
+    PERF_ICACHE_EVICT,
+    PERF_ICACHE_STALL,
+    PERF_DCACHE_HITS,
+    PERF_DCACHE_MISSES,
+    PERF_DCACHE_EVICT,
+    PERF_DCACHE_STALL,
+    PERF_MULDIV,
+    PERF_DIV_STALL,
+    PERF_BRANCH_STALL,
+    PERF_DUAL_ISSUE,
+    PERF_FUSED,
+    PERF_NUM_COUNTERS
+};
+
+const char* perf_counter_name(unsigned index);
+
+struct PerfSnapshot {
+    uint64_t values[PERF_NUM_COUNTERS] = {};
+
+    uint64_t operator[](unsigned index) const { return values[index]; }
+    double cpi() const;
+
+    // Приращения счётчиков с момента снимка since
+    PerfSnapshot operator-(const PerfSnapshot& since) const {
+        PerfSnapshot delta;
+        for (unsigned i = 0; i < PERF_NUM_COUNTERS; ++i) {
+            delta.values[i] = values[i] - since.values[i];
+        }
+        return delta;
+    }
+};
+
+// Чтение счётчиков perf_counters через экспортируемую DPI-функцию perf_dpi_read.
+class PerfCounters {
+public:
+    PerfCounters();
+
+    bool valid() const { return scope_ != nullptr; }
+    bool read(PerfSnapshot& snapshot) const;
+    uint64_t read(PerfCounter counter) const;
+
+private:
+    svScope scope_;
+};
+
+void print_perf_summary(std::ostream& out, const PerfSnapshot& snapshot);
+void write_perf_csv_header(std::ostream& out);
+void write_perf_csv_row(std::ostream& out, const PerfSnapshot& snapshot);
+
+#endif // PERF_COUNTERS_H
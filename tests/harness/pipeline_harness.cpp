@@ -0,0 +1,306 @@
+#include "pipeline_harness.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "arch_state.h"
+#include "checkpoint.h"
+#include "ram_access.h"
+
+// Время у каждой модели своё (VerilatedContext::time()); глобальная функция нужна только
+// сборкам Verilator, которые ещё вызывают её, пока время контекста не задано.
+double sc_time_stamp() {
+    return 0;
+}
+
+PipelineHarness::PipelineHarness(const SimOptions& opts) : opts_(opts), context_(new VerilatedContext) {
+    // Образы памяти передаются в ram.sv через +instr_mem=/+data_mem= (INIT_PLUSARG);
+    // их нужно добавить до первого eval(), когда выполняются initial-блоки. Аргументы
+    // у каждого контекста свои, поэтому в одном процессе могут идти разные программы.
+    std::vector<std::string> plusargs = opts.plusargs;
+    if (!opts.instr_mem_file.empty()) {
+        plusargs.push_back("+instr_mem=" + opts.instr_mem_file);
+    }
+    if (!opts.data_mem_file.empty()) {
+        plusargs.push_back("+data_mem=" + opts.data_mem_file);
+    }
+    std::vector<const char*> args;
+    for (const std::string& arg : plusargs) {
+        args.push_back(arg.c_str());
+    }
+    context_->commandArgsAdd(static_cast<int>(args.size()), args.data());
+    bind_context();
+
+    top_ = new Vpipeline(context_.get());
+    top_->clk_i = 0;
+    top_->rst_i = 0;
+    top_->pc_start_i = opts.pc_start;
+    // Первый eval() выполняет initial-блоки (обнуление/$readmemh) до записи через DPI
+    top_->eval();
+
+    perf_.reset(new PerfCounters);
+    if (!opts.perf.csv_file.empty()) {
+        perf_csv_.open(opts.perf.csv_file, std::ios::out | std::ios::trunc);
+        if (perf_csv_.is_open()) {
+            write_perf_csv_header(perf_csv_);
+        } else {
+            std::cerr << "ERROR: Could not open perf CSV file: " << opts.perf.csv_file << std::endl;
+        }
+    }
+    if (opts.profile.enabled()) {
+        profiler_.reset(new PcProfiler(opts.profile, *perf_));
+    }
+    if (!opts.trace.kanata_file.empty()) {
+        kanata_.reset(new KanataTrace(opts.trace));
+        if (!kanata_->open()) {
+            kanata_.reset();
+        }
+    }
+}
+
+PipelineHarness::~PipelineHarness() {
+    PerfSnapshot perf;
+    if (read_perf(perf)) {
+        if (!opts_.quiet) {
+            print_perf_summary(std::cout, perf);
+        }
+        if (perf_csv_.is_open()) {
+            write_perf_csv_row(perf_csv_, perf);
+        }
+    }
+    if (profiler_) {
+        profiler_->write_reports(opts_.test_name);
+    }
+    // Строку разбирает regression_runner, чтобы положить число тактов в отчёт
+    if (!opts_.quiet) {
+        std::cout << "SIM RESULT: cycles=" << cycle_ << std::endl;
+    }
+    tracer_.reset();
+    kanata_.reset();
+    if (top_) {
+        top_->final();
+        delete top_;
+    }
+}
+
+bool PipelineHarness::load_program() {
+    if (opts_.elf_file.empty()) {
+        return true;
+    }
+    return load_elf(opts_.elf_file);
+}
+
+bool PipelineHarness::load_elf(const std::string& path) {
+    ElfImage& image = elf_image_;
+    if (!load_elf_file(path, image)) {
+        return false;
+    }
+
+    bind_context();
+    RamAccess ram_instr(RAM_INSTR_SCOPE);
+    RamAccess ram_data(RAM_DATA_SCOPE);
+    if (!ram_instr.valid() || !ram_data.valid()) {
+        return false;
+    }
+
+    // Исполняемые сегменты попадают в память инструкций, все сегменты (.text,
+    // .rodata, .data, .bss) -- в память данных, чтобы работали загрузки констант.
+    for (const ElfSegment& segment : image.segments) {
+        uint64_t bss_size = segment.mem_size - segment.data.size();
+        if (segment.executable()) {
+            ram_instr.write_bytes(segment.vaddr, segment.data.data(), segment.data.size());
+        }
+        ram_data.write_bytes(segment.vaddr, segment.data.data(), segment.data.size());
+        ram_data.fill(segment.vaddr + segment.data.size(), 0, bss_size);
+    }
+
+    if (!opts_.pc_start_set) {
+        top_->pc_start_i = image.entry;
+    }
+    if (opts_.quiet) {
+        return true;
+    }
+    std::cout << "Loaded ELF " << path << ": " << image.segments.size() << " segment(s), entry 0x"
+              << std::hex << image.entry << std::dec << std::endl;
+    return true;
+}
+
+bool PipelineHarness::open_trace(const std::string& default_base_name) {
+    trace_base_name_ = default_base_name;
+    if (!opts_.trace.enabled()) {
+        return true;
+    }
+    tracer_.reset(new TraceControl(top_, opts_.trace));
+    return tracer_->open(default_base_name);
+}
+
+void PipelineHarness::report_failure() {
+    if (tracer_) {
+        tracer_->write_history(trace_base_name_ + "_failure.vcd");
+    }
+}
+
+void PipelineHarness::reset(int cycles) {
+    hold_reset(cycles);
+    save_requested_checkpoint();
+}
+
+void PipelineHarness::hold_reset(int cycles) {
+    top_->rst_i = 1;
+    for (int i = 0; i < cycles; ++i) {
+        tick();
+    }
+    top_->rst_i = 0;
+    cycle_ = 0;
+    if (profiler_) {
+        profiler_->restart(*top_, elf_image_);
+    }
+    if (kanata_) {
+        kanata_->restart(*top_, cycle_);
+    }
+}
+
+bool PipelineHarness::start(RefHart* ref) {
+    if (opts_.fast_forward) {
+        RefHart own_ref;
+        if (!ref) {
+            own_ref.load(elf_image_);
+            own_ref.set_pc(top_->pc_start_i);
+            ref = &own_ref;
+        }
+        return fast_forward(*ref);
+    }
+    if (opts_.checkpoint.restore_file.empty()) {
+        reset();
+        return true;
+    }
+    CheckpointInfo info;
+    if (!restore_checkpoint(opts_.checkpoint.restore_file, top_, info)) {
+        return false;
+    }
+    cycle_ = info.cycle;
+    context_->time(info.sim_time);
+    if (profiler_) {
+        profiler_->restart(*top_, elf_image_);
+    }
+    if (kanata_) {
+        kanata_->restart(*top_, cycle_);
+    }
+    return true;
+}
+
+bool PipelineHarness::fast_forward(RefHart& ref) {
+    auto start_time = std::chrono::steady_clock::now();
+    if (ref.instret() < opts_.fast_forward) {
+        RefHart::StepResult result = ref.run(opts_.fast_forward - ref.instret());
+        if (result != RefHart::StepResult::Ok) {
+            std::cerr << "ERROR: Fast-forward stopped at pc 0x" << std::hex << ref.pc() << std::dec << " after "
+                      << ref.instret() << " of " << opts_.fast_forward << " instructions ("
+                      << (result == RefHart::StepResult::Halt ? "program halted" : "illegal instruction") << ")."
+                      << std::endl;
+            return false;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+    // Контрольная точка такта 0 -- уже с перенесённым состоянием
+    if (!load_arch_state(ref)) {
+        return false;
+    }
+    save_requested_checkpoint();
+    if (opts_.quiet) {
+        return true;
+    }
+    std::cout << "Fast-forwarded " << ref.instret() << " instructions in " << seconds
+              << " s, detailed simulation starts at pc 0x" << std::hex << ref.pc() << std::dec << std::endl;
+    return true;
+}
+
+bool PipelineHarness::load_arch_state(const RefHart& ref) {
+    // Сброс очищает регистры всех стадий и ставит выборку на pc_start_i (pipeline.sv),
+    // так что первой в Decode попадёт инструкция по PC эталона. Регистры и память пишутся
+    // после сброса: на первом его фронте Writeback прежнего прогона ещё пишет regfile.
+    top_->pc_start_i = ref.pc();
+    hold_reset(2);
+    bind_context();
+    return inject_arch_state(ref);
+}
+
+bool PipelineHarness::save_checkpoint(const std::string& path) {
+    CheckpointInfo info;
+    info.cycle = cycle_;
+    info.sim_time = context_->time();
+    return ::save_checkpoint(path, top_, info);
+}
+
+void PipelineHarness::save_requested_checkpoint() {
+    if (!opts_.checkpoint.save_file.empty() && cycle_ == opts_.checkpoint.save_cycle && !top_->rst_i) {
+        save_checkpoint(opts_.checkpoint.save_file);
+    }
+}
+
+void PipelineHarness::bind_context() {
+    // svGetScopeFromName ищет области DPI в контексте текущего потока
+    Verilated::threadContextp(context_.get());
+}
+
+bool PipelineHarness::read_perf(PerfSnapshot& snapshot) const {
+    return perf_ && perf_->read(snapshot);
+}
+
+uint64_t PipelineHarness::perf_counter(PerfCounter counter) const {
+    return perf_ ? perf_->read(counter) : 0;
+}
+
+int PipelineHarness::reg_writes(RegWrite (&writes)[2]) const {
+    int count = 0;
+    if (top_->we3_d_o && top_->wa3_d_o != 0) {
+        writes[count++] = {top_->pc_w_o, static_cast<uint8_t>(top_->wa3_d_o), top_->wd3_d_o, top_->fused_w_o != 0};
+    }
+    if (top_->we6_d_o && top_->wa6_d_o != 0) {
+        writes[count++] = {top_->pc_w2_o, static_cast<uint8_t>(top_->wa6_d_o), top_->wd6_d_o, false};
+    }
+    return count;
+}
+
+bool PipelineHarness::mem_write(MemWrite& write) const {
+    if (!top_->mem_we_m_o) {
+        return false;
+    }
+    write = {top_->pc_m_o, top_->mem_adr_m_o, top_->mem_wd_m_o};
+    return true;
+}
+
+void PipelineHarness::tick() {
+    // Спад нужен Verilator, чтобы увидеть следующий фронт. В обычной сборке по нему
+    // пишет regfile; с SINGLE_EDGE=1 (PIPELINE_SINGLE_EDGE) по спаду ничего не
+    // срабатывает, и этот eval() сводится к проверке триггеров.
+    top_->clk_i = 0;
+    top_->eval();
+    if (tracer_) tracer_->dump(cycle_, context_->time());
+    context_->timeInc(1);
+
+    top_->clk_i = 1;
+    top_->eval();
+    if (tracer_) {
+        tracer_->dump(cycle_, context_->time());
+        tracer_->sample_ports(cycle_);
+    }
+    context_->timeInc(1);
+
+    cycle_++;
+    if (profiler_ && !top_->rst_i) {
+        profiler_->sample(*top_);
+    }
+    if (kanata_ && !top_->rst_i) {
+        kanata_->sample(*top_, cycle_);
+    }
+    save_requested_checkpoint();
+    if (opts_.perf.interval_cycles && perf_csv_.is_open() && cycle_ % opts_.perf.interval_cycles == 0) {
+        PerfSnapshot perf;
+        if (read_perf(perf)) {
+            write_perf_csv_row(perf_csv_, perf);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef PIPELINE_HARNESS_H
+#define PIPELINE_HARNESS_H
+
+#include "Vpipeline.h"
+#include "verilated.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "elf_loader.h"
+#include "kanata_trace.h"
+#include "pc_profile.h"
+#include "perf_counters.h"
+#include "ref_hart.h"
+#include "sim_options.h"
+#include "trace_control.h"
+
+// Запись в регистр, которую Writeback делает на текущем такте
+struct RegWrite {
+    uint64_t pc;
+    uint8_t rd;
+    uint64_t value;
+    bool fused;    // MACRO_FUSION: запись завершает и команду по адресу pc + 4
+};
+
+struct MemWrite {
+    uint64_t pc;
+    uint64_t addr;
+    uint64_t data;
+};
+
+// Общая обвязка вокруг Vpipeline: загрузка программы, сброс и такты.
+// Программа, стартовый PC и число тактов приходят из SimOptions во время выполнения,
+// поэтому одна собранная модель обслуживает все тесты. У каждой обвязки свой
+// VerilatedContext (время, plusargs, области DPI), так что несколько экземпляров могут
+// работать в одном процессе -- по одному на поток (см. cosim_tests/pipeline_batch_tb.cpp).
+class PipelineHarness {
+public:
+    explicit PipelineHarness(const SimOptions& opts);
+    ~PipelineHarness();
+
+    PipelineHarness(const PipelineHarness&) = delete;
+    PipelineHarness& operator=(const PipelineHarness&) = delete;
+
+    Vpipeline* top() { return top_; }
+    VerilatedContext* context() { return context_.get(); }
+
+    // Загружает ELF из --elf напрямую в ram_instr/ram_data (hex-образы уже
+    // подхвачены через plusargs). Вызывать до reset().
+    bool load_program();
+
+    // Образ последнего загруженного ELF (для эталонной модели).
+    const ElfImage& program_image() const { return elf_image_; }
+
+    // Включает трассировку согласно opts.trace; при --trace off ничего не стоит.
+    bool open_trace(const std::string& default_base_name);
+
+    // Сбрасывает кольцевой буфер --trace-history в <default_base_name>_failure.vcd.
+    void report_failure();
+
+    // Держит rst_i заданное число тактов и отпускает его.
+    void reset(int cycles = 2);
+
+    // Начало прогона: восстановление из --checkpoint-restore, иначе reset().
+    // С --fast-forward N первые N инструкций выполняет RefHart (ref, если передан, --
+    // например эталон lockstep-сверки, иначе собственный), затем его PC, регистры и
+    // память данных переносятся в Vpipeline, и потактовое моделирование идёт с этой точки.
+    bool start(RefHart* ref = nullptr);
+
+    // Детальное моделирование с архитектурного состояния ref: сброс с pc_start_i = ref.pc(),
+    // затем регистры и память данных ref переносятся в модель (arch_state.h).
+    // Сброс очищает все регистры стадий, поэтому вызывать можно и на модели, которая уже
+    // работала (окна выборки): инструкции прежнего прогона не завершатся после переноса.
+    // Сброс обнуляет и perf_counters, так что счёт идёт с этой точки.
+    bool load_arch_state(const RefHart& ref);
+
+    // Полное состояние модели в файл (см. checkpoint.h).
+    bool save_checkpoint(const std::string& path);
+
+    // Один такт: negedge (запись в regfile) и posedge.
+    void tick();
+
+    // Число тактов после снятия сброса.
+    uint64_t cycle() const { return cycle_; }
+
+    // Инструкция SYSTEM (ecall/ebreak/xret) дошла до WB: программа завершилась.
+    bool halted() const { return top_->halt_o; }
+
+    // Записи в регистры (rd != x0) этого такта в программном порядке: первый слот
+    // Writeback, затем второй (DUAL_ISSUE). Возвращает их число, не больше двух.
+    int reg_writes(RegWrite (&writes)[2]) const;
+
+    // Запись в память данных на следующем фронте (store в Memory без остановки).
+    // Она младше записей reg_writes этого такта. false -- записи нет.
+    bool mem_write(MemWrite& write) const;
+
+    // Текущие значения счётчиков perf_counters (false, если их не удалось прочитать).
+    bool read_perf(PerfSnapshot& snapshot) const;
+
+    // Один счётчик (дешевле полного снимка, если опрашивать каждый такт); 0 при ошибке.
+    uint64_t perf_counter(PerfCounter counter) const;
+
+private:
+    bool load_elf(const std::string& path);
+    bool fast_forward(RefHart& ref);
+    void hold_reset(int cycles);
+    void bind_context();
+    void save_requested_checkpoint();
+
+    SimOptions opts_;
+    ElfImage elf_image_;
+    std::unique_ptr<VerilatedContext> context_;
+    Vpipeline* top_ = nullptr;
+    std::unique_ptr<TraceControl> tracer_;
+    std::string trace_base_name_;
+    uint64_t cycle_ = 0;
+    std::unique_ptr<PerfCounters> perf_;
+    std::ofstream perf_csv_;
+    std::unique_ptr<PcProfiler> profiler_;   // только с --profile/--profile-folded
+    std::unique_ptr<KanataTrace> kanata_;    // только с --kanata
+};
+
+#endif // PIPELINE_HARNESS_H
@@ -0,0 +1,62 @@
+#include "ram_access.h"
+
+#include "Vpipeline__Dpi.h"
+
+#include <iostream>
+
+RamAccess::RamAccess(const char* scope_name) : scope_(svGetScopeFromName(scope_name)) {
+    if (!scope_) {
+        std::cerr << "ERROR: DPI scope not found: " << scope_name << std::endl;
+        return;
+    }
+    svSetScope(scope_);
+    word_bytes_ = static_cast<unsigned>(ram_dpi_word_bytes());
+}
+
+uint64_t RamAccess::read_word(uint64_t byte_addr) const {
+    svSetScope(scope_);
+    return ram_dpi_read(byte_addr);
+}
+
+void RamAccess::write_word(uint64_t byte_addr, uint64_t value) {
+    svSetScope(scope_);
+    ram_dpi_write(byte_addr, value);
+}
+
+void RamAccess::write_byte_range(uint64_t word_addr, unsigned first_byte, const uint8_t* bytes, unsigned count) {
+    uint64_t word = (first_byte == 0 && count == word_bytes_) ? 0 : read_word(word_addr);
+    for (unsigned i = 0; i < count; ++i) {
+        unsigned shift = (first_byte + i) * 8;
+        word &= ~(0xFFULL << shift);
+        word |= static_cast<uint64_t>(bytes[i]) << shift;
+    }
+    write_word(word_addr, word);
+}
+
+void RamAccess::write_bytes(uint64_t byte_addr, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        uint64_t word_addr = byte_addr - (byte_addr % word_bytes_);
+        unsigned first_byte = static_cast<unsigned>(byte_addr - word_addr);
+        unsigned count = word_bytes_ - first_byte;
+        if (count > size) {
+            count = static_cast<unsigned>(size);
+        }
+        write_byte_range(word_addr, first_byte, data, count);
+        byte_addr += count;
+        data += count;
+        size -= count;
+    }
+}
+
+void RamAccess::fill(uint64_t byte_addr, uint8_t value, size_t size) {
+    uint8_t chunk[8];
+    for (uint8_t& b : chunk) {
+        b = value;
+    }
+    while (size > 0) {
+        size_t count = size < sizeof(chunk) ? size : sizeof(chunk);
+        write_bytes(byte_addr, chunk, count);
+        byte_addr += count;
+        size -= count;
+    }
+}
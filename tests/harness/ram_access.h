@@ -0,0 +1,38 @@
+#ifndef RAM_ACCESS_H
+#define RAM_ACCESS_H
+
+#include "svdpi.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Иерархические имена экземпляров ram внутри Vpipeline
+#define RAM_INSTR_SCOPE "TOP.pipeline.ram_instr"
+#define RAM_DATA_SCOPE  "TOP.pipeline.ram_data"
+
+// Прямой доступ к массиву mem экземпляра ram через экспортируемые DPI-функции
+// (ram_dpi_read/ram_dpi_write), минуя $readmemh и порты модуля.
+// Пользоваться можно только после первого eval(): до него initial-блок ram
+// ещё не отработал и затрёт записанное.
+class RamAccess {
+public:
+    explicit RamAccess(const char* scope_name);
+
+    bool valid() const { return scope_ != nullptr; }
+    unsigned word_bytes() const { return word_bytes_; }
+
+    uint64_t read_word(uint64_t byte_addr) const;
+    void write_word(uint64_t byte_addr, uint64_t value);
+
+    // Побайтовая запись с read-modify-write для невыровненных краёв.
+    void write_bytes(uint64_t byte_addr, const uint8_t* data, size_t size);
+    void fill(uint64_t byte_addr, uint8_t value, size_t size);
+
+private:
+    void write_byte_range(uint64_t word_addr, unsigned first_byte, const uint8_t* bytes, unsigned count);
+
+    svScope scope_;
+    unsigned word_bytes_ = 0;
+};
+
+#endif // RAM_ACCESS_H
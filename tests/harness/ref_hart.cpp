@@ -0,0 +1,518 @@
+#include "ref_hart.h"
+
+#include <cstring>
+
+// Шитый код (labels as values) есть в GCC и Clang; иначе -- обычный switch в цикле
+#if defined(__GNUC__)
+#define REF_HART_THREADED 1
+#else
+#define REF_HART_THREADED 0
+#endif
+
+namespace {
+
+inline int64_t sext(uint64_t value, unsigned bits) {
+    uint64_t m = 1ULL << (bits - 1);
+    value &= (bits == 64) ? ~0ULL : ((1ULL << bits) - 1);
+    return static_cast<int64_t>((value ^ m) - m);
+}
+
+inline uint64_t bits(uint32_t instr, unsigned hi, unsigned lo) {
+    return (instr >> lo) & ((1U << (hi - lo + 1)) - 1);
+}
+
+inline int64_t imm_i(uint32_t instr) { return sext(bits(instr, 31, 20), 12); }
+inline int64_t imm_s(uint32_t instr) { return sext((bits(instr, 31, 25) << 5) | bits(instr, 11, 7), 12); }
+inline int64_t imm_b(uint32_t instr) {
+    return sext((bits(instr, 31, 31) << 12) | (bits(instr, 7, 7) << 11) |
+                (bits(instr, 30, 25) << 5) | (bits(instr, 11, 8) << 1), 13);
+}
+inline int64_t imm_u(uint32_t instr) { return sext(instr & 0xFFFFF000U, 32); }
+inline int64_t imm_j(uint32_t instr) {
+    return sext((bits(instr, 31, 31) << 20) | (bits(instr, 19, 12) << 12) |
+                (bits(instr, 20, 20) << 11) | (bits(instr, 30, 21) << 1), 21);
+}
+
+// M-расширение: деление на ноль и переполнение (MIN / -1) не исключения, а фиксированные
+// результаты спецификации. width = 32 -- W-вариант (операнды -- младшие 32 бита).
+inline uint64_t mulhu(uint64_t a, uint64_t b) {
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+}
+inline uint64_t mulh(uint64_t a, uint64_t b) {
+    return static_cast<uint64_t>((static_cast<__int128>(static_cast<int64_t>(a)) * static_cast<int64_t>(b)) >> 64);
+}
+inline uint64_t mulhsu(uint64_t a, uint64_t b) {
+    return static_cast<uint64_t>((static_cast<__int128>(static_cast<int64_t>(a)) *
+                                  static_cast<__int128>(b)) >> 64);
+}
+inline uint64_t div_signed(uint64_t a, uint64_t b, unsigned width) {
+    const int64_t x = sext(a, width);
+    const int64_t y = sext(b, width);
+    if (y == 0) return ~0ULL;
+    if (y == -1) return static_cast<uint64_t>(0) - static_cast<uint64_t>(x);   // MIN / -1 = MIN
+    return static_cast<uint64_t>(x / y);
+}
+inline uint64_t rem_signed(uint64_t a, uint64_t b, unsigned width) {
+    const int64_t x = sext(a, width);
+    const int64_t y = sext(b, width);
+    if (y == 0) return static_cast<uint64_t>(x);
+    if (y == -1) return 0;
+    return static_cast<uint64_t>(x % y);
+}
+inline uint64_t divu_w(uint64_t a, uint64_t b) {
+    const uint32_t x = static_cast<uint32_t>(a);
+    const uint32_t y = static_cast<uint32_t>(b);
+    return y ? x / y : ~0ULL;
+}
+inline uint64_t remu_w(uint64_t a, uint64_t b) {
+    const uint32_t x = static_cast<uint32_t>(a);
+    const uint32_t y = static_cast<uint32_t>(b);
+    return y ? x % y : x;
+}
+
+inline bool is_store(RefHart::Op op) {
+    return op >= RefHart::OP_SB && op <= RefHart::OP_SD;
+}
+
+inline bool writes_rd(RefHart::Op op) {
+    return !(op >= RefHart::OP_BEQ && op <= RefHart::OP_BGEU) && !is_store(op) && op < RefHart::OP_FENCE;
+}
+
+// Блок заканчивается на инструкции, после которой PC не обязательно pc + 4
+inline bool ends_block(RefHart::Op op) {
+    return (op >= RefHart::OP_JAL && op <= RefHart::OP_BGEU) || op >= RefHart::OP_SYSTEM;
+}
+
+} // namespace
+
+RefHart::RefHart() {
+    regs_.fill(0);
+}
+
+void RefHart::load(const ElfImage& image) {
+    flush_blocks();
+    for (const ElfSegment& segment : image.segments) {
+        for (uint64_t i = 0; i < segment.mem_size; ++i) {
+            store_byte(segment.vaddr + i, i < segment.data.size() ? segment.data[i] : 0);
+        }
+    }
+    pc_ = image.entry;
+}
+
+void RefHart::set_reg(unsigned index, uint64_t value) {
+    if ((index & 31) != 0) {
+        regs_[index & 31] = value;
+    }
+}
+
+RefHart::Page* RefHart::find_page(uint64_t addr) const {
+    const uint64_t index = addr >> PAGE_BITS;
+    if (index == last_page_index_) {
+        return last_page_;
+    }
+    auto it = pages_.find(index);
+    if (it == pages_.end()) {
+        return nullptr;
+    }
+    last_page_index_ = index;
+    last_page_ = it->second.get();
+    return last_page_;
+}
+
+RefHart::Page* RefHart::page_for_write(uint64_t addr) {
+    Page* page = find_page(addr);
+    if (!page) {
+        std::unique_ptr<Page>& slot = pages_[addr >> PAGE_BITS];
+        slot.reset(new Page());
+        page = slot.get();
+        last_page_index_ = addr >> PAGE_BITS;
+        last_page_ = page;
+    }
+    return page;
+}
+
+uint8_t RefHart::load_byte(uint64_t addr) const {
+    const Page* page = find_page(addr);
+    return page ? page->bytes[addr & (PAGE_SIZE - 1)] : 0;
+}
+
+void RefHart::store_byte(uint64_t addr, uint8_t value) {
+    Page* page = page_for_write(addr);
+    page->bytes[addr & (PAGE_SIZE - 1)] = value;
+    if (page->has_code) {
+        note_code_store(*page, addr, 1);
+    }
+}
+
+// addr..addr + size - 1 внутри одной страницы
+void RefHart::note_code_store(const Page& page, uint64_t addr, unsigned size) {
+    for (uint64_t word = addr >> 2; word <= (addr + size - 1) >> 2; ++word) {
+        if (page.code_words[word & (PAGE_SIZE / 4 - 1)]) {
+            code_stores_.push_back(word << 2);
+        }
+    }
+}
+
+// Хост little-endian, как и формат commit-трассы: доступ внутри страницы -- одним memcpy
+uint64_t RefHart::load_mem(uint64_t addr, unsigned size) const {
+    const uint64_t offset = addr & (PAGE_SIZE - 1);
+    uint64_t value = 0;
+    if (offset + size <= PAGE_SIZE) {
+        const Page* page = find_page(addr);
+        if (page) {
+            std::memcpy(&value, page->bytes + offset, size);
+        }
+        return value;
+    }
+    for (unsigned i = 0; i < size; ++i) {
+        value |= static_cast<uint64_t>(load_byte(addr + i)) << (8 * i);
+    }
+    return value;
+}
+
+void RefHart::store_mem(uint64_t addr, uint64_t value, unsigned size) {
+    const uint64_t offset = addr & (PAGE_SIZE - 1);
+    if (offset + size <= PAGE_SIZE) {
+        Page* page = page_for_write(addr);
+        std::memcpy(page->bytes + offset, &value, size);
+        if (page->has_code) {
+            note_code_store(*page, addr, size);
+        }
+        return;
+    }
+    for (unsigned i = 0; i < size; ++i) {
+        store_byte(addr + i, static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+RefHart::DecodedInstr RefHart::decode(uint32_t instr) {
+    static const Op BRANCH_OPS[8] = {OP_BEQ, OP_BNE, OP_ILLEGAL, OP_ILLEGAL, OP_BLT, OP_BGE, OP_BLTU, OP_BGEU};
+    static const Op LOAD_OPS[8] = {OP_LB, OP_LH, OP_LW, OP_LD, OP_LBU, OP_LHU, OP_LWU, OP_ILLEGAL};
+    static const Op OP_IMM_OPS[8] = {OP_ADDI, OP_SLLI, OP_SLTI, OP_SLTIU, OP_XORI, OP_SRLI, OP_ORI, OP_ANDI};
+    static const Op OP_OPS[8] = {OP_ADD, OP_SLL, OP_SLT, OP_SLTU, OP_XOR, OP_SRL, OP_OR, OP_AND};
+    static const Op M_OPS[8] = {OP_MUL, OP_MULH, OP_MULHSU, OP_MULHU, OP_DIV, OP_DIVU, OP_REM, OP_REMU};
+    static const Op M_W_OPS[8] = {OP_MULW, OP_ILLEGAL, OP_ILLEGAL, OP_ILLEGAL,
+                                  OP_DIVW, OP_DIVUW, OP_REMW, OP_REMUW};
+
+    const unsigned rd = bits(instr, 11, 7);
+    const unsigned funct3 = bits(instr, 14, 12);
+    const bool funct7_5 = bits(instr, 30, 30) != 0;
+
+    DecodedInstr d;
+    d.op = OP_ILLEGAL;
+    d.rd = static_cast<uint8_t>(rd != 0 ? rd : REG_SINK);
+    d.rs1 = static_cast<uint8_t>(bits(instr, 19, 15));
+    d.rs2 = static_cast<uint8_t>(bits(instr, 24, 20));
+    d.raw = instr;
+    d.imm = 0;
+
+    switch (instr & 0x7F) {
+    case 0x37: d.op = OP_LUI; d.imm = imm_u(instr); break;
+    case 0x17: d.op = OP_AUIPC; d.imm = imm_u(instr); break;
+    case 0x6F: d.op = OP_JAL; d.imm = imm_j(instr); break;
+    case 0x67: d.op = OP_JALR; d.imm = imm_i(instr); break;
+    case 0x63: d.op = BRANCH_OPS[funct3]; d.imm = imm_b(instr); break;
+    case 0x03: d.op = LOAD_OPS[funct3]; d.imm = imm_i(instr); break;
+    case 0x23:
+        if (funct3 <= 3) {
+            d.op = static_cast<Op>(OP_SB + funct3);
+            d.imm = imm_s(instr);
+        }
+        break;
+    case 0x13: // OP-IMM
+        d.op = OP_IMM_OPS[funct3];
+        if (funct3 == 1 || funct3 == 5) {
+            d.imm = bits(instr, 25, 20);
+            if (funct3 == 5 && funct7_5) {
+                d.op = OP_SRAI;
+            }
+        } else {
+            d.imm = imm_i(instr);
+        }
+        break;
+    case 0x33: // OP; funct7 = 1 -- M-расширение
+        if ((bits(instr, 31, 25) & ~0x20U) == 0) {
+            d.op = OP_OPS[funct3];
+            if (funct7_5 && funct3 == 0) d.op = OP_SUB;
+            if (funct7_5 && funct3 == 5) d.op = OP_SRA;
+        } else if (bits(instr, 31, 25) == 1) {
+            d.op = M_OPS[funct3];
+        }
+        break;
+    case 0x1B: // OP-IMM-32
+        d.imm = bits(instr, 24, 20);
+        switch (funct3) {
+        case 0: d.op = OP_ADDIW; d.imm = imm_i(instr); break;
+        case 1: d.op = OP_SLLIW; break;
+        case 5: d.op = funct7_5 ? OP_SRAIW : OP_SRLIW; break;
+        }
+        break;
+    case 0x3B: // OP-32
+        if ((bits(instr, 31, 25) & ~0x20U) == 0) {
+            switch (funct3) {
+            case 0: d.op = funct7_5 ? OP_SUBW : OP_ADDW; break;
+            case 1: d.op = OP_SLLW; break;
+            case 5: d.op = funct7_5 ? OP_SRAW : OP_SRLW; break;
+            }
+        } else if (bits(instr, 31, 25) == 1) {
+            d.op = M_W_OPS[funct3];
+        }
+        break;
+    case 0x0F: d.op = OP_FENCE; break;
+    case 0x73: d.op = OP_SYSTEM; break; // ecall/ebreak/xret -- конец программы
+    }
+    return d;
+}
+
+const RefHart::Block& RefHart::block_at(uint64_t pc) {
+    BlockSlot& slot = block_slots_[(pc >> 2) & (BLOCK_CACHE_SLOTS - 1)];
+    if (slot.pc == pc) {
+        return *slot.block;
+    }
+    auto it = blocks_.find(pc);
+    if (it == blocks_.end()) {
+        Block block;
+        uint64_t addr = pc;
+        do {
+            block.push_back(decode(static_cast<uint32_t>(load_mem(addr, 4))));
+            addr += 4;
+        } while (!ends_block(block.back().op) && block.size() < MAX_BLOCK_INSTRS &&
+                 (addr & (PAGE_SIZE - 1)) != 0);
+        // Страница заводится и для кода из незаписанной памяти (нули): иначе её слова
+        // негде пометить и блок не выбросится, когда туда позже запишут код
+        for (uint64_t word = pc >> 2; word <= (addr - 1) >> 2; ++word) {
+            Page* page = page_for_write(word << 2);
+            page->has_code = true;
+            page->code_words.set(word & (PAGE_SIZE / 4 - 1));
+        }
+        it = blocks_.emplace(pc, std::move(block)).first;
+    }
+    slot.pc = pc;
+    slot.block = &it->second;
+    return it->second;
+}
+
+void RefHart::flush_blocks() {
+    blocks_.clear();
+    block_slots_.fill(BlockSlot());
+    for (auto& entry : pages_) {
+        entry.second->has_code = false;
+        entry.second->code_words.reset();
+    }
+    code_stores_.clear();
+}
+
+// Выбрасывает блоки, которые покрывают изменённые слова. Блок начинается не дальше
+// MAX_BLOCK_INSTRS инструкций до слова, PC чётный. Биты code_words остаются: слово может
+// входить и в другие блоки, а лишний бит стоит только поиска при следующей записи.
+void RefHart::invalidate_code_stores() {
+    const uint64_t span = 4 * MAX_BLOCK_INSTRS;
+    for (uint64_t word : code_stores_) {
+        for (uint64_t pc = word >= span ? word - span + 2 : 0; pc < word + 4; pc += 2) {
+            auto it = blocks_.find(pc);
+            if (it == blocks_.end() || pc + 4 * it->second.size() <= word) {
+                continue;
+            }
+            BlockSlot& slot = block_slots_[(pc >> 2) & (BLOCK_CACHE_SLOTS - 1)];
+            if (slot.pc == pc) {
+                slot = BlockSlot();
+            }
+            blocks_.erase(it);
+        }
+    }
+    code_stores_.clear();
+}
+
+size_t RefHart::execute(const DecodedInstr* block, size_t n, StepResult& result) {
+    uint64_t* const x = regs_.data();
+    uint64_t pc = pc_;
+    const DecodedInstr* d = block;
+    const DecodedInstr* const end = block + n;
+    result = StepResult::Ok;
+
+// После обычной инструкции -- следующая в блоке; переходы и остановы выходят из блока
+#define NEXT() { pc += 4; if (++d == end) goto done; DISPATCH(); }
+#define LEAVE(target) do { pc = (target); ++d; goto done; } while (0)
+
+#if REF_HART_THREADED
+    static const void* const DISPATCH_TABLE[OP_COUNT] = {
+        &&L_OP_LUI, &&L_OP_AUIPC, &&L_OP_JAL, &&L_OP_JALR,
+        &&L_OP_BEQ, &&L_OP_BNE, &&L_OP_BLT, &&L_OP_BGE, &&L_OP_BLTU, &&L_OP_BGEU,
+        &&L_OP_LB, &&L_OP_LH, &&L_OP_LW, &&L_OP_LD, &&L_OP_LBU, &&L_OP_LHU, &&L_OP_LWU,
+        &&L_OP_SB, &&L_OP_SH, &&L_OP_SW, &&L_OP_SD,
+        &&L_OP_ADDI, &&L_OP_SLTI, &&L_OP_SLTIU, &&L_OP_XORI, &&L_OP_ORI, &&L_OP_ANDI,
+        &&L_OP_SLLI, &&L_OP_SRLI, &&L_OP_SRAI,
+        &&L_OP_ADD, &&L_OP_SUB, &&L_OP_SLL, &&L_OP_SLT, &&L_OP_SLTU, &&L_OP_XOR,
+        &&L_OP_SRL, &&L_OP_SRA, &&L_OP_OR, &&L_OP_AND,
+        &&L_OP_ADDIW, &&L_OP_SLLIW, &&L_OP_SRLIW, &&L_OP_SRAIW,
+        &&L_OP_ADDW, &&L_OP_SUBW, &&L_OP_SLLW, &&L_OP_SRLW, &&L_OP_SRAW,
+        &&L_OP_MUL, &&L_OP_MULH, &&L_OP_MULHSU, &&L_OP_MULHU, &&L_OP_DIV, &&L_OP_DIVU, &&L_OP_REM, &&L_OP_REMU,
+        &&L_OP_MULW, &&L_OP_DIVW, &&L_OP_DIVUW, &&L_OP_REMW, &&L_OP_REMUW,
+        &&L_OP_FENCE, &&L_OP_SYSTEM, &&L_OP_ILLEGAL,
+    };
+#define CASE(op) L_##op
+#define DISPATCH() goto *DISPATCH_TABLE[d->op]
+    DISPATCH();
+#else
+#define CASE(op) case op
+#define DISPATCH() continue
+    for (;;) switch (d->op) {
+#endif
+
+    CASE(OP_LUI):   x[d->rd] = d->imm; NEXT();
+    CASE(OP_AUIPC): x[d->rd] = pc + d->imm; NEXT();
+    CASE(OP_JAL):   x[d->rd] = pc + 4; LEAVE(pc + d->imm);
+    CASE(OP_JALR): {
+        uint64_t target = (x[d->rs1] + d->imm) & ~1ULL;
+        x[d->rd] = pc + 4;
+        LEAVE(target);
+    }
+
+    CASE(OP_BEQ):  LEAVE(x[d->rs1] == x[d->rs2] ? pc + d->imm : pc + 4);
+    CASE(OP_BNE):  LEAVE(x[d->rs1] != x[d->rs2] ? pc + d->imm : pc + 4);
+    CASE(OP_BLT):  LEAVE(static_cast<int64_t>(x[d->rs1]) < static_cast<int64_t>(x[d->rs2]) ? pc + d->imm : pc + 4);
+    CASE(OP_BGE):  LEAVE(static_cast<int64_t>(x[d->rs1]) >= static_cast<int64_t>(x[d->rs2]) ? pc + d->imm : pc + 4);
+    CASE(OP_BLTU): LEAVE(x[d->rs1] < x[d->rs2] ? pc + d->imm : pc + 4);
+    CASE(OP_BGEU): LEAVE(x[d->rs1] >= x[d->rs2] ? pc + d->imm : pc + 4);
+
+    CASE(OP_LB):  x[d->rd] = sext(load_mem(x[d->rs1] + d->imm, 1), 8); NEXT();
+    CASE(OP_LH):  x[d->rd] = sext(load_mem(x[d->rs1] + d->imm, 2), 16); NEXT();
+    CASE(OP_LW):  x[d->rd] = sext(load_mem(x[d->rs1] + d->imm, 4), 32); NEXT();
+    CASE(OP_LD):  x[d->rd] = load_mem(x[d->rs1] + d->imm, 8); NEXT();
+    CASE(OP_LBU): x[d->rd] = load_mem(x[d->rs1] + d->imm, 1); NEXT();
+    CASE(OP_LHU): x[d->rd] = load_mem(x[d->rs1] + d->imm, 2); NEXT();
+    CASE(OP_LWU): x[d->rd] = load_mem(x[d->rs1] + d->imm, 4); NEXT();
+
+    // Запись в слово с кодом: остаток блока мог устареть, блоки выбросит вызывающий
+    CASE(OP_SB):
+    CASE(OP_SH):
+    CASE(OP_SW):
+    CASE(OP_SD):
+        store_mem(x[d->rs1] + d->imm, x[d->rs2], 1U << (d->op - OP_SB));
+        if (!code_stores_.empty()) {
+            LEAVE(pc + 4);
+        }
+        NEXT();
+
+    CASE(OP_ADDI):  x[d->rd] = x[d->rs1] + d->imm; NEXT();
+    CASE(OP_SLTI):  x[d->rd] = static_cast<int64_t>(x[d->rs1]) < d->imm ? 1 : 0; NEXT();
+    CASE(OP_SLTIU): x[d->rd] = x[d->rs1] < static_cast<uint64_t>(d->imm) ? 1 : 0; NEXT();
+    CASE(OP_XORI):  x[d->rd] = x[d->rs1] ^ d->imm; NEXT();
+    CASE(OP_ORI):   x[d->rd] = x[d->rs1] | d->imm; NEXT();
+    CASE(OP_ANDI):  x[d->rd] = x[d->rs1] & d->imm; NEXT();
+    CASE(OP_SLLI):  x[d->rd] = x[d->rs1] << d->imm; NEXT();
+    CASE(OP_SRLI):  x[d->rd] = x[d->rs1] >> d->imm; NEXT();
+    CASE(OP_SRAI):  x[d->rd] = static_cast<uint64_t>(static_cast<int64_t>(x[d->rs1]) >> d->imm); NEXT();
+
+    CASE(OP_ADD):  x[d->rd] = x[d->rs1] + x[d->rs2]; NEXT();
+    CASE(OP_SUB):  x[d->rd] = x[d->rs1] - x[d->rs2]; NEXT();
+    CASE(OP_SLL):  x[d->rd] = x[d->rs1] << (x[d->rs2] & 63); NEXT();
+    CASE(OP_SLT):  x[d->rd] = static_cast<int64_t>(x[d->rs1]) < static_cast<int64_t>(x[d->rs2]) ? 1 : 0; NEXT();
+    CASE(OP_SLTU): x[d->rd] = x[d->rs1] < x[d->rs2] ? 1 : 0; NEXT();
+    CASE(OP_XOR):  x[d->rd] = x[d->rs1] ^ x[d->rs2]; NEXT();
+    CASE(OP_SRL):  x[d->rd] = x[d->rs1] >> (x[d->rs2] & 63); NEXT();
+    CASE(OP_SRA):  x[d->rd] = static_cast<uint64_t>(static_cast<int64_t>(x[d->rs1]) >> (x[d->rs2] & 63)); NEXT();
+    CASE(OP_OR):   x[d->rd] = x[d->rs1] | x[d->rs2]; NEXT();
+    CASE(OP_AND):  x[d->rd] = x[d->rs1] & x[d->rs2]; NEXT();
+
+    CASE(OP_ADDIW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) + static_cast<uint32_t>(d->imm), 32); NEXT();
+    CASE(OP_SLLIW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) << d->imm, 32); NEXT();
+    CASE(OP_SRLIW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) >> d->imm, 32); NEXT();
+    CASE(OP_SRAIW): x[d->rd] = sext(static_cast<uint32_t>(static_cast<int32_t>(x[d->rs1]) >> d->imm), 32); NEXT();
+
+    CASE(OP_ADDW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) + static_cast<uint32_t>(x[d->rs2]), 32); NEXT();
+    CASE(OP_SUBW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) - static_cast<uint32_t>(x[d->rs2]), 32); NEXT();
+    CASE(OP_SLLW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) << (x[d->rs2] & 31), 32); NEXT();
+    CASE(OP_SRLW): x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) >> (x[d->rs2] & 31), 32); NEXT();
+    CASE(OP_SRAW):
+        x[d->rd] = sext(static_cast<uint32_t>(static_cast<int32_t>(x[d->rs1]) >> (x[d->rs2] & 31)), 32);
+        NEXT();
+
+    CASE(OP_MUL):    x[d->rd] = x[d->rs1] * x[d->rs2]; NEXT();
+    CASE(OP_MULH):   x[d->rd] = mulh(x[d->rs1], x[d->rs2]); NEXT();
+    CASE(OP_MULHSU): x[d->rd] = mulhsu(x[d->rs1], x[d->rs2]); NEXT();
+    CASE(OP_MULHU):  x[d->rd] = mulhu(x[d->rs1], x[d->rs2]); NEXT();
+    CASE(OP_DIV):    x[d->rd] = div_signed(x[d->rs1], x[d->rs2], 64); NEXT();
+    CASE(OP_DIVU):   x[d->rd] = x[d->rs2] ? x[d->rs1] / x[d->rs2] : ~0ULL; NEXT();
+    CASE(OP_REM):    x[d->rd] = rem_signed(x[d->rs1], x[d->rs2], 64); NEXT();
+    CASE(OP_REMU):   x[d->rd] = x[d->rs2] ? x[d->rs1] % x[d->rs2] : x[d->rs1]; NEXT();
+
+    CASE(OP_MULW):  x[d->rd] = sext(static_cast<uint32_t>(x[d->rs1]) * static_cast<uint32_t>(x[d->rs2]), 32); NEXT();
+    CASE(OP_DIVW):  x[d->rd] = sext(div_signed(x[d->rs1], x[d->rs2], 32), 32); NEXT();
+    CASE(OP_DIVUW): x[d->rd] = sext(divu_w(x[d->rs1], x[d->rs2]), 32); NEXT();
+    CASE(OP_REMW):  x[d->rd] = sext(rem_signed(x[d->rs1], x[d->rs2], 32), 32); NEXT();
+    CASE(OP_REMUW): x[d->rd] = sext(remu_w(x[d->rs1], x[d->rs2]), 32); NEXT();
+
+    CASE(OP_FENCE): NEXT();
+
+    // Не выполняются: pc остаётся на инструкции
+    CASE(OP_SYSTEM):
+        result = StepResult::Halt;
+        goto done;
+    CASE(OP_ILLEGAL):
+        result = StepResult::IllegalInstr;
+        goto done;
+#if !REF_HART_THREADED
+    default:
+        result = StepResult::IllegalInstr;
+        goto done;
+    }
+#endif
+
+#undef NEXT
+#undef LEAVE
+#undef CASE
+#undef DISPATCH
+
+done:
+    const size_t executed = static_cast<size_t>(d - block);
+    pc_ = pc;
+    instret_ += executed;
+    return executed;
+}
+
+RefHart::StepResult RefHart::step(RetireInfo& info) {
+    const DecodedInstr d = block_at(pc_).front();
+
+    info = RetireInfo();
+    info.pc = pc_;
+    info.instr = d.raw;
+    info.rd = static_cast<uint8_t>(bits(d.raw, 11, 7));
+    if (is_store(d.op)) {
+        unsigned size = 1U << (d.op - OP_SB);
+        uint64_t data = regs_[d.rs2];
+        info.mem_addr = regs_[d.rs1] + d.imm;
+        info.mem_data = size == 8 ? data : (data & ((1ULL << (8 * size)) - 1));
+    }
+
+    StepResult result;
+    execute(&d, 1, result);
+    if (!code_stores_.empty()) {
+        invalidate_code_stores();
+    }
+    if (result != StepResult::Ok) {
+        return result;
+    }
+    info.mem_write = is_store(d.op);
+    if (writes_rd(d.op) && d.rd != REG_SINK) {
+        info.rd_written = true;
+        info.rd_value = regs_[d.rd];
+    }
+    return StepResult::Ok;
+}
+
+RefHart::StepResult RefHart::run(uint64_t count) {
+    while (count > 0) {
+        const Block& block = block_at(pc_);
+        const size_t n = block.size() < count ? block.size() : static_cast<size_t>(count);
+        StepResult result;
+        count -= execute(block.data(), n, result);
+        if (!code_stores_.empty()) {
+            invalidate_code_stores();
+        }
+        if (result != StepResult::Ok) {
+            return result;
+        }
+    }
+    return StepResult::Ok;
+}
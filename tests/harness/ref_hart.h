@@ -0,0 +1,140 @@
+#ifndef REF_HART_H
+#define REF_HART_H
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "elf_loader.h"
+
+// Что сделала одна выполненная (retired) инструкция.
+struct RetireInfo {
+    uint64_t pc = 0;
+    uint32_t instr = 0;
+    uint8_t rd = 0;
+    bool rd_written = false;   // запись в rd != x0
+    uint64_t rd_value = 0;
+    bool mem_write = false;
+    uint64_t mem_addr = 0;
+    uint64_t mem_data = 0;
+};
+
+// Функциональная модель RV64IM: эталон для lockstep-сверки с Vpipeline, быстрая прокрутка
+// (--fast-forward, выборочное моделирование) и генерация ожидаемых commit-трасс (ref_trace).
+// Память -- разреженная побайтовая, x0 всегда ноль, инструкции SYSTEM (ecall,
+// ebreak, sret, ...) останавливают модель.
+//
+// Инструкции декодируются один раз и кэшируются базовыми блоками (до перехода, SYSTEM или
+// границы страницы); run() исполняет блоки с шитым кодом (computed goto в GCC/Clang).
+// Запись в слово, из которого декодировался код, выбрасывает только блоки с этим словом.
+class RefHart {
+public:
+    enum class StepResult { Ok, Halt, IllegalInstr };
+
+    RefHart();
+
+    void load(const ElfImage& image);
+
+    uint64_t pc() const { return pc_; }
+    void set_pc(uint64_t pc) { pc_ = pc; }
+    uint64_t reg(unsigned index) const { return regs_[index & 31]; }
+    void set_reg(unsigned index, uint64_t value);
+    uint64_t instret() const { return instret_; }
+
+    uint64_t load_mem(uint64_t addr, unsigned size) const;
+    void store_mem(uint64_t addr, uint64_t value, unsigned size);
+
+    // Одна инструкция с подробностями для сверки.
+    StepResult step(RetireInfo& info);
+
+    // До count инструкций без RetireInfo (быстрый путь). Ok -- выполнены все count;
+    // иначе pc() указывает на инструкцию, на которой модель остановилась.
+    StepResult run(uint64_t count);
+
+    // Обходит все выделенные страницы памяти: f(базовый адрес, PAGE_SIZE байт).
+    // Страница появляется при первой записи (загрузка ELF или store).
+    template <typename F>
+    void for_each_page(F f) const {
+        for (const auto& entry : pages_) {
+            f(entry.first << PAGE_BITS, entry.second->bytes, static_cast<size_t>(PAGE_SIZE));
+        }
+    }
+
+    // Операции после декодирования; порядок совпадает с таблицей переходов в ref_hart.cpp.
+    enum Op : uint8_t {
+        OP_LUI, OP_AUIPC, OP_JAL, OP_JALR,
+        OP_BEQ, OP_BNE, OP_BLT, OP_BGE, OP_BLTU, OP_BGEU,
+        OP_LB, OP_LH, OP_LW, OP_LD, OP_LBU, OP_LHU, OP_LWU,
+        OP_SB, OP_SH, OP_SW, OP_SD,
+        OP_ADDI, OP_SLTI, OP_SLTIU, OP_XORI, OP_ORI, OP_ANDI, OP_SLLI, OP_SRLI, OP_SRAI,
+        OP_ADD, OP_SUB, OP_SLL, OP_SLT, OP_SLTU, OP_XOR, OP_SRL, OP_SRA, OP_OR, OP_AND,
+        OP_ADDIW, OP_SLLIW, OP_SRLIW, OP_SRAIW,
+        OP_ADDW, OP_SUBW, OP_SLLW, OP_SRLW, OP_SRAW,
+        OP_MUL, OP_MULH, OP_MULHSU, OP_MULHU, OP_DIV, OP_DIVU, OP_REM, OP_REMU,
+        OP_MULW, OP_DIVW, OP_DIVUW, OP_REMW, OP_REMUW,
+        OP_FENCE, OP_SYSTEM, OP_ILLEGAL,
+        OP_COUNT
+    };
+
+    struct DecodedInstr {
+        Op op;
+        uint8_t rd;      // x0 заменён на REG_SINK: запись туда не видна
+        uint8_t rs1;
+        uint8_t rs2;
+        uint32_t raw;
+        int64_t imm;     // для сдвигов -- shamt
+    };
+
+private:
+    static const unsigned PAGE_BITS = 12;
+    static const uint64_t PAGE_SIZE = 1ULL << PAGE_BITS;
+    static const unsigned REG_SINK = 32;
+    static const size_t MAX_BLOCK_INSTRS = 64;
+    static const size_t BLOCK_CACHE_SLOTS = 1024;
+
+    struct Page {
+        uint8_t bytes[PAGE_SIZE] = {};
+        bool has_code = false;                  // из страницы декодированы блоки
+        std::bitset<PAGE_SIZE / 4> code_words;  // слова, которые входят в блоки
+    };
+    typedef std::vector<DecodedInstr> Block;
+
+    struct BlockSlot {
+        uint64_t pc = ~0ULL;
+        const Block* block = nullptr;
+    };
+
+    static DecodedInstr decode(uint32_t instr);
+
+    Page* find_page(uint64_t addr) const;   // страницы принадлежат pages_, константность неглубокая
+    Page* page_for_write(uint64_t addr);
+    uint8_t load_byte(uint64_t addr) const;
+    void store_byte(uint64_t addr, uint8_t value);
+    void note_code_store(const Page& page, uint64_t addr, unsigned size);
+
+    const Block& block_at(uint64_t pc);
+    void flush_blocks();
+    void invalidate_code_stores();
+
+    // Исполняет первые n инструкций блока; возвращает число выполненных.
+    size_t execute(const DecodedInstr* block, size_t n, StepResult& result);
+
+    std::array<uint64_t, 33> regs_;   // [32] -- REG_SINK
+    uint64_t pc_ = 0;
+    uint64_t instret_ = 0;
+    std::unordered_map<uint64_t, std::unique_ptr<Page>> pages_;
+    mutable uint64_t last_page_index_ = ~0ULL;
+    mutable Page* last_page_ = nullptr;
+
+    std::unordered_map<uint64_t, Block> blocks_;
+    std::array<BlockSlot, BLOCK_CACHE_SLOTS> block_slots_;
+    // Слова с кодом, в которые писал store: их блоки выбрасываются после исполнения
+    // текущего блока (он сам может оказаться среди них)
+    std::vector<uint64_t> code_stores_;
+};
+
+#endif // REF_HART_H
@@ -0,0 +1,100 @@
+// Ожидаемая commit-трасса программы от эталонной модели RefHart: по записи на каждую
+// выполненную инструкцию (pc, запись в регистр, запись в память). Сравнивается с трассой
+// RTL через commit_trace_diff вместо внешнего Simulator.
+// --check-run повторяет программу быстрым путём RefHart::run() и сверяет итог с пошаговым
+// (PC, число инструкций, регистры): так проверяется кэш блоков, в том числе на
+// самомодифицирующемся коде, который RTL не исполняет.
+#include "commit_trace.h"
+#include "elf_loader.h"
+#include "ref_hart.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    uint64_t max_instr = UINT64_MAX;
+    bool check_run = false;
+    std::string elf_file;
+    std::string output_file;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--max-instr") == 0 && i + 1 < argc) {
+            max_instr = std::stoull(argv[++i], nullptr, 0);
+        } else if (std::strcmp(argv[i], "--check-run") == 0) {
+            check_run = true;
+        } else if (elf_file.empty()) {
+            elf_file = argv[i];
+        } else if (output_file.empty()) {
+            output_file = argv[i];
+        } else {
+            elf_file.clear();
+            break;
+        }
+    }
+    if (elf_file.empty() || output_file.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--max-instr <n>] [--check-run] <prog.elf> <trace.bin>" << std::endl;
+        return 2;
+    }
+
+    ElfImage image;
+    if (!load_elf_file(elf_file, image)) {
+        return 2;
+    }
+    CommitTraceWriter writer;
+    if (!writer.open(output_file)) {
+        std::cerr << "ERROR: Could not open output file: " << output_file << std::endl;
+        return 2;
+    }
+
+    RefHart hart;
+    hart.load(image);
+    RetireInfo info;
+    RefHart::StepResult result = RefHart::StepResult::Ok;
+    while (hart.instret() < max_instr) {
+        result = hart.step(info);
+        if (result != RefHart::StepResult::Ok) {
+            break;
+        }
+        CommitRecord record;
+        record.cycle = hart.instret();
+        record.pc = info.pc;
+        record.flags = COMMIT_PC_VALID;
+        if (info.rd_written) {
+            record.rd = info.rd;
+            record.value = info.rd_value;
+            record.flags |= COMMIT_REG_WRITE;
+        }
+        if (info.mem_write) {
+            record.mem_addr = info.mem_addr;
+            record.mem_data = info.mem_data;
+            record.flags |= COMMIT_MEM_WRITE;
+        }
+        writer.append(record);
+    }
+    writer.close();
+
+    std::cout << "Reference trace: " << hart.instret() << " instructions, stopped at pc 0x" << std::hex
+              << hart.pc() << std::dec << " ("
+              << (result == RefHart::StepResult::Halt ? "halt"
+                  : result == RefHart::StepResult::IllegalInstr ? "illegal instruction" : "instruction limit")
+              << ")" << std::endl;
+    if (result == RefHart::StepResult::IllegalInstr) {
+        return 1;
+    }
+
+    if (check_run) {
+        RefHart fast;
+        fast.load(image);
+        const RefHart::StepResult fast_result = fast.run(max_instr);
+        bool same = fast_result == result && fast.pc() == hart.pc() && fast.instret() == hart.instret();
+        for (unsigned i = 1; i < 32 && same; ++i) {
+            same = fast.reg(i) == hart.reg(i);
+        }
+        if (!same) {
+            std::cerr << "ERROR: run() stopped at pc 0x" << std::hex << fast.pc() << std::dec << " after "
+                      << fast.instret() << " instructions with a different state than step()." << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
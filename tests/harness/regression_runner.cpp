@@ -0,0 +1,361 @@
+// Параллельный прогон всех зарегистрированных тестов (unit, pipeline, cosim).
+// Список берётся из манифеста, который пишет tests/CMakeLists.txt: по строке на тест,
+// поля через табуляцию -- набор, имя, рабочая директория и командная строка.
+// Каждый тест -- отдельный процесс со своей моделью; вывод уходит в <workdir>/<name>.log.
+// Итог собирается в один JSON и JUnit XML.
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct TestCase {
+    std::string suite;
+    std::string name;
+    std::string working_dir;
+    std::vector<std::string> argv;
+};
+
+enum class Outcome { Passed, Failed, TimedOut, NotStarted };
+
+struct TestResult {
+    Outcome outcome = Outcome::NotStarted;
+    int exit_code = -1;
+    uint64_t cycles = 0;
+    double seconds = 0.0;
+    std::string log_file;
+};
+
+struct RunnerOptions {
+    std::string manifest;
+    std::string json_file;
+    std::string junit_file;
+    std::string filter;
+    unsigned jobs = 0;
+    double timeout_seconds = 0.0;
+};
+
+void print_usage(const char* prog_name) {
+    std::cerr << "Usage: " << prog_name << " --manifest <file> [--jobs <n>] [--filter <substring>]\n"
+              << "         [--timeout <seconds>] [--json <report.json>] [--junit <report.xml>]" << std::endl;
+}
+
+bool parse_options(int argc, char** argv, RunnerOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "ERROR: Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (arg == "--manifest") {
+                opts.manifest = value;
+            } else if (arg == "--jobs") {
+                opts.jobs = static_cast<unsigned>(std::stoul(value));
+            } else if (arg == "--filter") {
+                opts.filter = value;
+            } else if (arg == "--timeout") {
+                opts.timeout_seconds = std::stod(value);
+            } else if (arg == "--json") {
+                opts.json_file = value;
+            } else if (arg == "--junit") {
+                opts.junit_file = value;
+            } else {
+                std::cerr << "ERROR: Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "ERROR: Invalid value for " << arg << ": " << value << std::endl;
+            return false;
+        }
+    }
+    if (opts.manifest.empty()) {
+        std::cerr << "ERROR: --manifest is required" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool read_manifest(const RunnerOptions& opts, std::vector<TestCase>& tests) {
+    std::ifstream file(opts.manifest);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open manifest: " << opts.manifest << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, '\t')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 4) {
+            std::cerr << "ERROR: Malformed manifest line: " << line << std::endl;
+            return false;
+        }
+        TestCase test;
+        test.suite = fields[0];
+        test.name = fields[1];
+        test.working_dir = fields[2];
+        test.argv.assign(fields.begin() + 3, fields.end());
+        if (!opts.filter.empty() && (test.suite + "/" + test.name).find(opts.filter) == std::string::npos) {
+            continue;
+        }
+        tests.push_back(test);
+    }
+    return true;
+}
+
+// Число тактов берётся из строки "SIM RESULT: cycles=N", которую печатает PipelineHarness
+uint64_t parse_cycles(const std::string& log_file) {
+    std::ifstream log(log_file);
+    std::string line;
+    const std::string marker = "SIM RESULT: cycles=";
+    uint64_t cycles = 0;
+    while (std::getline(log, line)) {
+        if (line.compare(0, marker.size(), marker) == 0) {
+            cycles = std::strtoull(line.c_str() + marker.size(), nullptr, 10);
+        }
+    }
+    return cycles;
+}
+
+TestResult run_test(const TestCase& test, double timeout_seconds) {
+    TestResult result;
+    result.log_file = test.working_dir + "/" + test.name + ".log";
+
+    // Всё, что нужно дочернему процессу, готовится до fork(): после него в
+    // многопоточной программе допустимы только async-signal-safe вызовы.
+    std::vector<char*> child_argv;
+    for (const std::string& arg : test.argv) {
+        child_argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    child_argv.push_back(nullptr);
+    const char* work_dir = test.working_dir.c_str();
+    const char* log_path = result.log_file.c_str();
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "ERROR: fork failed for " << test.name << ": " << std::strerror(errno) << std::endl;
+        return result;
+    }
+    if (pid == 0) {
+        int fd = -1;
+        if (chdir(work_dir) == 0) {
+            fd = open(log_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        }
+        if (fd < 0) {
+            _exit(127);
+        }
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        execv(child_argv[0], child_argv.data());
+        _exit(127);
+    }
+
+    int status = 0;
+    bool timed_out = false;
+    while (true) {
+        pid_t done = waitpid(pid, &status, WNOHANG);
+        if (done == pid) {
+            break;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!timed_out && timeout_seconds > 0.0 && elapsed > timeout_seconds) {
+            kill(pid, SIGKILL);
+            timed_out = true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (timed_out) {
+        result.outcome = Outcome::TimedOut;
+    } else if (WIFEXITED(status)) {
+        result.exit_code = WEXITSTATUS(status);
+        result.outcome = result.exit_code == 0 ? Outcome::Passed : Outcome::Failed;
+    } else {
+        result.exit_code = WIFSIGNALED(status) ? 128 + WTERMSIG(status) : -1;
+        result.outcome = Outcome::Failed;
+    }
+    result.cycles = parse_cycles(result.log_file);
+    return result;
+}
+
+const char* outcome_name(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::Passed:     return "passed";
+        case Outcome::Failed:     return "failed";
+        case Outcome::TimedOut:   return "timeout";
+        case Outcome::NotStarted: return "not_started";
+    }
+    return "unknown";
+}
+
+std::string escape(const std::string& text, bool xml) {
+    std::string out;
+    for (char c : text) {
+        if (xml) {
+            switch (c) {
+                case '&':  out += "&amp;"; break;
+                case '<':  out += "&lt;"; break;
+                case '>':  out += "&gt;"; break;
+                case '"':  out += "&quot;"; break;
+                default:   out += c;
+            }
+        } else {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default:   out += c;
+            }
+        }
+    }
+    return out;
+}
+
+bool write_json(const std::string& path, const std::vector<TestCase>& tests,
+                const std::vector<TestResult>& results, double wall_seconds) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not write JSON report: " << path << std::endl;
+        return false;
+    }
+    out << "{\n  \"wall_seconds\": " << wall_seconds << ",\n  \"tests\": [\n";
+    for (size_t i = 0; i < tests.size(); ++i) {
+        const TestResult& r = results[i];
+        out << "    {\"suite\": \"" << escape(tests[i].suite, false) << "\", \"name\": \""
+            << escape(tests[i].name, false) << "\", \"result\": \"" << outcome_name(r.outcome)
+            << "\", \"exit_code\": " << r.exit_code << ", \"cycles\": " << r.cycles
+            << ", \"seconds\": " << r.seconds << ", \"log\": \"" << escape(r.log_file, false) << "\"}"
+            << (i + 1 < tests.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+    return true;
+}
+
+bool write_junit(const std::string& path, const std::vector<TestCase>& tests,
+                 const std::vector<TestResult>& results, double wall_seconds) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not write JUnit report: " << path << std::endl;
+        return false;
+    }
+    size_t failures = 0;
+    for (const TestResult& r : results) {
+        failures += r.outcome != Outcome::Passed;
+    }
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    out << "<testsuite name=\"riscv_verilogsim\" tests=\"" << tests.size() << "\" failures=\"" << failures
+        << "\" time=\"" << wall_seconds << "\">\n";
+    for (size_t i = 0; i < tests.size(); ++i) {
+        const TestResult& r = results[i];
+        out << "  <testcase classname=\"" << escape(tests[i].suite, true) << "\" name=\""
+            << escape(tests[i].name, true) << "\" time=\"" << r.seconds << "\">\n";
+        out << "    <properties><property name=\"cycles\" value=\"" << r.cycles << "\"/></properties>\n";
+        if (r.outcome != Outcome::Passed) {
+            out << "    <failure message=\"" << outcome_name(r.outcome) << ", exit code " << r.exit_code
+                << "\">See " << escape(r.log_file, true) << "</failure>\n";
+        }
+        out << "  </testcase>\n";
+    }
+    out << "</testsuite>\n";
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    RunnerOptions opts;
+    if (!parse_options(argc, argv, opts)) {
+        print_usage(argv[0]);
+        return 2;
+    }
+    std::vector<TestCase> tests;
+    if (!read_manifest(opts, tests)) {
+        return 2;
+    }
+    if (tests.empty()) {
+        std::cerr << "ERROR: No tests selected from " << opts.manifest << std::endl;
+        return 2;
+    }
+
+    unsigned jobs = opts.jobs ? opts.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min<unsigned>(jobs, static_cast<unsigned>(tests.size()));
+    std::cout << "Running " << tests.size() << " tests on " << jobs << " workers" << std::endl;
+
+    std::vector<TestResult> results(tests.size());
+    std::atomic<size_t> next_test(0);
+    std::atomic<size_t> finished(0);
+    std::mutex print_mutex;
+
+    auto wall_start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < jobs; ++w) {
+        workers.emplace_back([&]() {
+            for (size_t i = next_test++; i < tests.size(); i = next_test++) {
+                results[i] = run_test(tests[i], opts.timeout_seconds);
+                std::lock_guard<std::mutex> lock(print_mutex);
+                const TestResult& r = results[i];
+                std::cout << "[" << std::setw(4) << ++finished << "/" << tests.size() << "] "
+                          << (r.outcome == Outcome::Passed ? "PASS " : "FAIL ") << tests[i].suite << "/"
+                          << tests[i].name << " (" << std::fixed << std::setprecision(2) << r.seconds << " s";
+                if (r.cycles) {
+                    std::cout << ", " << r.cycles << " cycles";
+                }
+                std::cout << ")" << std::defaultfloat << std::endl;
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    size_t failed = 0;
+    for (size_t i = 0; i < tests.size(); ++i) {
+        if (results[i].outcome != Outcome::Passed) {
+            if (failed++ == 0) {
+                std::cout << "\nFailed tests:" << std::endl;
+            }
+            std::cout << "  " << tests[i].suite << "/" << tests[i].name << " (" << outcome_name(results[i].outcome)
+                      << "), log: " << results[i].log_file << std::endl;
+        }
+    }
+    std::cout << "\n" << tests.size() - failed << "/" << tests.size() << " tests passed in "
+              << std::fixed << std::setprecision(2) << wall_seconds << " s" << std::endl;
+
+    bool reports_ok = true;
+    if (!opts.json_file.empty()) {
+        reports_ok &= write_json(opts.json_file, tests, results, wall_seconds);
+    }
+    if (!opts.junit_file.empty()) {
+        reports_ok &= write_junit(opts.junit_file, tests, results, wall_seconds);
+    }
+    return (failed == 0 && reports_ok) ? 0 : 1;
+}
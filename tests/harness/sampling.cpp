@@ -0,0 +1,72 @@
+#include "sampling.h"
+
+#include <cmath>
+#include <iomanip>
+
+namespace {
+
+const char* const SAMPLE_METRIC_NAMES[SAMPLE_NUM_METRICS] = {
+    "cpi",
+    "load_use_stalls_per_instr",
+    "branch_flushes_per_instr",
+    "jump_flushes_per_instr",
+};
+
+} // namespace
+
+void SampleEstimate::add(double value) {
+    count_++;
+    double delta = value - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (value - mean_);
+}
+
+double SampleEstimate::stddev() const {
+    return count_ > 1 ? std::sqrt(m2_ / (count_ - 1)) : 0.0;
+}
+
+double SampleEstimate::coefficient_of_variation() const {
+    return mean_ != 0.0 ? stddev() / mean_ : 0.0;
+}
+
+double SampleEstimate::half_width(double z) const {
+    return count_ > 0 ? z * stddev() / std::sqrt(static_cast<double>(count_)) : 0.0;
+}
+
+uint64_t SampleEstimate::required_samples(double z, double rel_error) const {
+    double n = z * coefficient_of_variation() / rel_error;
+    return static_cast<uint64_t>(std::ceil(n * n));
+}
+
+const char* sample_metric_name(unsigned metric) {
+    return metric < SAMPLE_NUM_METRICS ? SAMPLE_METRIC_NAMES[metric] : "unknown";
+}
+
+void SampledPerf::add_window(const PerfSnapshot& delta) {
+    const double instret = static_cast<double>(delta[PERF_INSTRET]);
+    if (instret == 0.0) {
+        return;
+    }
+    metrics_[SAMPLE_CPI].add(delta[PERF_CYCLES] / instret);
+    metrics_[SAMPLE_LOAD_USE_STALLS].add(delta[PERF_LOAD_USE_STALL] / instret);
+    metrics_[SAMPLE_BRANCH_FLUSHES].add(delta[PERF_BRANCH_FLUSH] / instret);
+    metrics_[SAMPLE_JUMP_FLUSHES].add(delta[PERF_JUMP_FLUSH] / instret);
+}
+
+void SampledPerf::print(std::ostream& out) const {
+    out << "SAMPLE: " << windows() << " windows, estimates with 95% confidence intervals\n" << std::fixed;
+    for (unsigned i = 0; i < SAMPLE_NUM_METRICS; ++i) {
+        const SampleEstimate& m = metrics_[i];
+        double half = m.half_width(SAMPLE_Z_95);
+        out << "SAMPLE: " << std::setw(26) << std::left << sample_metric_name(i) << std::right
+            << std::setprecision(4) << m.mean() << " +- " << half;
+        if (m.mean() != 0.0) {
+            out << " (" << std::setprecision(2) << 100.0 * half / m.mean() << "%)";
+        }
+        out << "\n";
+    }
+    const SampleEstimate& cpi = metrics_[SAMPLE_CPI];
+    out << "SAMPLE: CPI coefficient of variation " << std::setprecision(3) << cpi.coefficient_of_variation()
+        << ", windows needed for +-3% at 99.7%: " << cpi.required_samples(SAMPLE_Z_997, 0.03)
+        << std::defaultfloat << std::endl;
+}
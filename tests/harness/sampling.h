@@ -0,0 +1,60 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "perf_counters.h"
+
+// z-квантили нормального распределения: 95% -- для отчёта, 99.7% -- цель SMARTS
+const double SAMPLE_Z_95 = 1.96;
+const double SAMPLE_Z_997 = 3.0;
+
+// Среднее и дисперсия по окнам выборки (алгоритм Уэлфорда, без хранения окон).
+class SampleEstimate {
+public:
+    void add(double value);
+
+    size_t count() const { return count_; }
+    double mean() const { return mean_; }
+    double stddev() const;                 // выборочное, с n-1
+    double coefficient_of_variation() const;
+    // Полуширина доверительного интервала среднего: z * s / sqrt(n)
+    double half_width(double z) const;
+    // Сколько окон нужно, чтобы полуширина стала не больше rel_error * mean
+    uint64_t required_samples(double z, double rel_error) const;
+
+private:
+    size_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+enum SampleMetric : unsigned {
+    SAMPLE_CPI = 0,
+    SAMPLE_LOAD_USE_STALLS,  // на инструкцию
+    SAMPLE_BRANCH_FLUSHES,   // на инструкцию
+    SAMPLE_JUMP_FLUSHES,     // на инструкцию
+    SAMPLE_NUM_METRICS
+};
+
+const char* sample_metric_name(unsigned metric);
+
+// Оценки CPI и частот остановов/сбросов конвейера по измеренным окнам.
+// Окна одинаковой длины в инструкциях, поэтому среднее по окнам -- несмещённая оценка.
+class SampledPerf {
+public:
+    // delta -- приращения perf_counters за одно окно
+    void add_window(const PerfSnapshot& delta);
+
+    size_t windows() const { return metrics_[SAMPLE_CPI].count(); }
+    const SampleEstimate& metric(unsigned index) const { return metrics_[index]; }
+
+    void print(std::ostream& out) const;
+
+private:
+    SampleEstimate metrics_[SAMPLE_NUM_METRICS];
+};
+
+#endif // SAMPLING_H
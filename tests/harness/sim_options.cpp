@@ -0,0 +1,166 @@
+#include "sim_options.h"
+
+#include <iostream>
+#include <stdexcept>
+
+static bool parse_u64(const std::string& str, uint64_t& value) {
+    try {
+        size_t pos = 0;
+        value = std::stoull(str, &pos, 0); // 0x... -> hex, иначе dec
+        return pos == str.size();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool parse_trace_format(const std::string& name, TraceFormat& format) {
+    if (name == "off") {
+        format = TraceFormat::Off;
+    } else if (name == "vcd") {
+        format = TraceFormat::Vcd;
+    } else if (name == "fst") {
+        format = TraceFormat::Fst;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void print_sim_options_usage(const char* prog_name) {
+    std::cerr << "Usage: " << prog_name << " (--elf <prog.elf> | --program <instr.hex> [--data <data.hex>])\n"
+              << "         [--pc-start <addr>] (--cycles <n> | --max-cycles <watchdog>)\n"
+              << "         [--name <test_name>] [--expected <file>] [--output <commit_trace.bin>]\n"
+              << "         [--trace off|vcd|fst] [--trace-file <file>] [--trace-start <cycle>]\n"
+              << "         [--trace-stop <cycle>] [--trace-history <cycles>] [--kanata <pipeline.log>]\n"
+              << "         [--perf-csv <file>] [--perf-interval <cycles>]\n"
+              << "         [--profile <report.txt>] [--profile-folded <stacks.folded>]\n"
+              << "         [--checkpoint-save <file> [--checkpoint-at <cycle>]] [--checkpoint-restore <file>]\n"
+              << "         [--fast-forward <instructions>]\n"
+              << "         [--samples <n> [--sample-interval <instr>] [--sample-warmup <instr>] [--sample-window <instr>]]\n"
+              << "         [--batch <elf_list> [--jobs <n>]]"
+              << std::endl;
+}
+
+bool parse_sim_options(int argc, char** argv, SimOptions& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (!arg.empty() && arg[0] == '+') {
+            opts.plusargs.push_back(arg);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "ERROR: Option " << arg << " requires a value." << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--name") {
+            opts.test_name = value;
+        } else if (arg == "--program") {
+            opts.instr_mem_file = value;
+        } else if (arg == "--data") {
+            opts.data_mem_file = value;
+        } else if (arg == "--elf") {
+            opts.elf_file = value;
+        } else if (arg == "--expected") {
+            opts.expected_file = value;
+        } else if (arg == "--output") {
+            opts.output_file = value;
+        } else if (arg == "--pc-start") {
+            if (!parse_u64(value, opts.pc_start)) {
+                std::cerr << "ERROR: Invalid --pc-start value: " << value << std::endl;
+                return false;
+            }
+            opts.pc_start_set = true;
+        } else if (arg == "--cycles" || arg == "--max-cycles") {
+            if (!parse_u64(value, arg == "--cycles" ? opts.num_cycles : opts.max_cycles)) {
+                std::cerr << "ERROR: Invalid " << arg << " value: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--trace") {
+            if (!parse_trace_format(value, opts.trace.format)) {
+                std::cerr << "ERROR: Invalid --trace value (expected off, vcd or fst): " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--trace-file") {
+            opts.trace.file_name = value;
+        } else if (arg == "--kanata") {
+            opts.trace.kanata_file = value;
+        } else if (arg == "--trace-start" || arg == "--trace-stop" || arg == "--trace-history") {
+            uint64_t* target = (arg == "--trace-start") ? &opts.trace.start_cycle
+                             : (arg == "--trace-stop")  ? &opts.trace.stop_cycle
+                                                        : &opts.trace.history_cycles;
+            if (!parse_u64(value, *target)) {
+                std::cerr << "ERROR: Invalid " << arg << " value: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--perf-csv") {
+            opts.perf.csv_file = value;
+        } else if (arg == "--perf-interval") {
+            if (!parse_u64(value, opts.perf.interval_cycles)) {
+                std::cerr << "ERROR: Invalid --perf-interval value: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--profile") {
+            opts.profile.report_file = value;
+        } else if (arg == "--profile-folded") {
+            opts.profile.folded_file = value;
+        } else if (arg == "--checkpoint-save") {
+            opts.checkpoint.save_file = value;
+        } else if (arg == "--checkpoint-restore") {
+            opts.checkpoint.restore_file = value;
+        } else if (arg == "--checkpoint-at") {
+            if (!parse_u64(value, opts.checkpoint.save_cycle)) {
+                std::cerr << "ERROR: Invalid --checkpoint-at value: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--fast-forward") {
+            if (!parse_u64(value, opts.fast_forward)) {
+                std::cerr << "ERROR: Invalid --fast-forward value: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--samples" || arg == "--sample-interval" || arg == "--sample-warmup" ||
+                   arg == "--sample-window") {
+            uint64_t* target = (arg == "--samples")         ? &opts.sampling.samples
+                             : (arg == "--sample-interval") ? &opts.sampling.interval
+                             : (arg == "--sample-warmup")   ? &opts.sampling.warmup
+                                                            : &opts.sampling.window;
+            if (!parse_u64(value, *target)) {
+                std::cerr << "ERROR: Invalid " << arg << " value: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--batch") {
+            opts.batch.list_file = value;
+        } else if (arg == "--jobs") {
+            uint64_t jobs = 0;
+            if (!parse_u64(value, jobs) || jobs > 4096) {
+                std::cerr << "ERROR: Invalid --jobs value: " << value << std::endl;
+                return false;
+            }
+            opts.batch.jobs = static_cast<unsigned>(jobs);
+        } else {
+            std::cerr << "ERROR: Unknown option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    // Память программы входит в контрольную точку, программы пакета перечислены в списке
+    if (opts.instr_mem_file.empty() && opts.elf_file.empty() && opts.checkpoint.restore_file.empty() &&
+        opts.batch.list_file.empty()) {
+        std::cerr << "ERROR: Either --program, --elf, --checkpoint-restore or --batch is required." << std::endl;
+        return false;
+    }
+    // Функциональной модели нужен ELF-образ, а состояние из контрольной точки ей неизвестно
+    if (opts.fast_forward && (opts.elf_file.empty() || !opts.checkpoint.restore_file.empty())) {
+        std::cerr << "ERROR: --fast-forward needs --elf and cannot be combined with --checkpoint-restore." << std::endl;
+        return false;
+    }
+    // Отчёты пишутся по имени файла, а в пакете все программы получили бы одно и то же
+    if ((opts.profile.enabled() || !opts.trace.kanata_file.empty() || !opts.perf.csv_file.empty()) &&
+        !opts.batch.list_file.empty()) {
+        std::cerr << "ERROR: --profile, --profile-folded, --kanata and --perf-csv cannot be combined with --batch."
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+#ifndef SIM_OPTIONS_H
+#define SIM_OPTIONS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class TraceFormat { Off, Vcd, Fst };
+
+// Режим трассировки выбирается при запуске: --trace off|vcd|fst, окно --trace-start/--trace-stop
+// (в тактах после сброса) и --trace-history K -- кольцевой буфер портов на K последних тактов,
+// который сбрасывается в VCD только при ошибке теста. --kanata <file> -- журнал прохождения
+// инструкций по стадиям для Konata (harness/kanata_trace.h), в том же окне; он не зависит
+// от трассировки сигналов и работает и в модели, собранной без неё.
+struct TraceOptions {
+    TraceFormat format = TraceFormat::Off;
+    std::string file_name;            // по умолчанию <имя теста>.vcd / .fst
+    std::string kanata_file;
+    uint64_t start_cycle = 0;
+    uint64_t stop_cycle = UINT64_MAX;
+    uint64_t history_cycles = 0;
+
+    bool enabled() const { return format != TraceFormat::Off || history_cycles > 0; }
+};
+
+bool parse_trace_format(const std::string& name, TraceFormat& format);
+
+// Счётчики производительности (rtl/modules/perf_counters.sv): сводка печатается в конце
+// прогона всегда, --perf-csv пишет их в CSV -- раз в --perf-interval тактов и в конце.
+struct PerfOptions {
+    std::string csv_file;
+    uint64_t interval_cycles = 0;
+};
+
+// Профиль по PC (harness/pc_profile.h): --profile <file> -- текстовый отчёт (такты,
+// завершённые инструкции, load-use простои и такты сброса по PC и по символам ELF),
+// --profile-folded <file> -- свёрнутые стеки вызовов для flame graph (flamegraph.pl, speedscope).
+struct ProfileOptions {
+    std::string report_file;
+    std::string folded_file;
+
+    bool enabled() const { return !report_file.empty() || !folded_file.empty(); }
+};
+
+// Контрольные точки (harness/checkpoint.h, модель собирается с PIPELINE_SAVABLE):
+// --checkpoint-save <file> --checkpoint-at <такт> сохраняет полное состояние модели
+// на этом такте после сброса и продолжает прогон, --checkpoint-restore <file>
+// начинает прогон с сохранённого состояния вместо загрузки программы и сброса.
+struct CheckpointOptions {
+    std::string save_file;
+    uint64_t save_cycle = 0;
+    std::string restore_file;
+};
+
+// Выборочное моделирование (SMARTS, benchmarks/pipeline_sample.cpp): между окнами RefHart
+// выполняет --sample-interval инструкций, затем состояние переносится в Vpipeline, первые
+// --sample-warmup инструкций заполняют конвейер, а следующие --sample-window измеряются.
+struct SamplingOptions {
+    uint64_t samples = 0;
+    uint64_t interval = 100000;
+    uint64_t warmup = 100;
+    uint64_t window = 1000;
+};
+
+// Пакетный прогон (cosim_tests/pipeline_batch_tb.cpp): --batch <список ELF> и --jobs N
+// экземпляров модели в потоках одного процесса; 0 -- по числу аппаратных потоков.
+struct BatchOptions {
+    std::string list_file;
+    unsigned jobs = 0;
+};
+
+// Параметры одного прогона общего (верилированного один раз) Vpipeline.
+// Раньше всё это зашивалось в модель через -G/-D при верилировании каждого теста.
+struct SimOptions {
+    std::string test_name = "pipeline";
+    std::string instr_mem_file;   // $readmemh-образ памяти инструкций
+    std::string data_mem_file;    // $readmemh-образ памяти данных (необязателен)
+    std::string elf_file;         // ELF, загружаемый напрямую в обе памяти
+    uint64_t pc_start = 0;
+    bool pc_start_set = false;    // иначе для ELF берётся e_entry
+    uint64_t num_cycles = 0;      // ровно столько тактов (тесты с потактовой таблицей)
+    uint64_t max_cycles = 0;      // до останова (SYSTEM в WB), это -- сторожевой предел
+    std::string expected_file;    // ожидаемые wd3 по тактам (pipeline_tb)
+    std::string output_file;      // двоичная commit-трасса записей в регистры (cosim)
+    uint64_t fast_forward = 0;    // столько инструкций до RTL выполняет RefHart (нужен --elf)
+    TraceOptions trace;
+    PerfOptions perf;
+    ProfileOptions profile;
+    CheckpointOptions checkpoint;
+    SamplingOptions sampling;
+    BatchOptions batch;
+    std::vector<std::string> plusargs;  // +plusarg и +verilator+* для VerilatedContext обвязки
+    bool quiet = false;           // без служебных строк и сводки (их печатает пакетный прогон)
+};
+
+// Разбирает --name, --program, --data, --elf, --pc-start, --cycles, --max-cycles, --expected, --output
+// и --trace, --trace-file, --kanata, --trace-start, --trace-stop, --trace-history, --perf-csv, --perf-interval,
+// --profile, --profile-folded, --checkpoint-save, --checkpoint-at, --checkpoint-restore, --fast-forward,
+// --samples, --sample-interval, --sample-warmup, --sample-window, --batch, --jobs.
+// Аргументы вида +plusarg и +verilator+* собираются в plusargs: обвязка передаёт их своему
+// VerilatedContext.
+bool parse_sim_options(int argc, char** argv, SimOptions& opts);
+
+void print_sim_options_usage(const char* prog_name);
+
+#endif // SIM_OPTIONS_H
@@ -0,0 +1,122 @@
+#include "sparse_memory.h"
+
+#include "svdpi.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+SparseMemory::SparseMemory(unsigned word_bytes)
+    : word_bytes_(word_bytes),
+      word_mask_(word_bytes >= 8 ? ~0ULL : ((1ULL << (word_bytes * 8)) - 1)) {}
+
+uint64_t* SparseMemory::find_page(uint64_t page_index) const {
+    if (page_index == last_page_index_) {
+        return last_page_;
+    }
+    auto it = pages_.find(page_index);
+    if (it == pages_.end()) {
+        return nullptr;
+    }
+    last_page_index_ = page_index;
+    last_page_ = it->second.get();
+    return last_page_;
+}
+
+uint64_t SparseMemory::read_word(uint64_t word_adr) const {
+    const uint64_t* page = find_page(word_adr >> PAGE_WORDS_LOG2);
+    return page ? page[word_adr & (PAGE_WORDS - 1)] : 0;
+}
+
+void SparseMemory::write_word(uint64_t word_adr, uint64_t value) {
+    uint64_t page_index = word_adr >> PAGE_WORDS_LOG2;
+    uint64_t* page = find_page(page_index);
+    if (!page) {
+        if (value == 0) {
+            return; // нулевая страница остаётся неявной
+        }
+        std::unique_ptr<uint64_t[]> new_page(new uint64_t[PAGE_WORDS]());
+        page = new_page.get();
+        pages_.emplace(page_index, std::move(new_page));
+        last_page_index_ = page_index;
+        last_page_ = page;
+    }
+    page[word_adr & (PAGE_WORDS - 1)] = value & word_mask_;
+}
+
+bool SparseMemory::load_hex(const std::string& file_name) {
+    std::ifstream file(file_name);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open memory image: " << file_name << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    uint64_t word_adr = 0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        char c = text[pos];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++pos;
+        } else if (text.compare(pos, 2, "//") == 0) {
+            pos = text.find('\n', pos);
+        } else if (text.compare(pos, 2, "/*") == 0) {
+            pos = text.find("*/", pos);
+            pos = (pos == std::string::npos) ? pos : pos + 2;
+        } else {
+            bool is_address = (c == '@');
+            if (is_address) {
+                ++pos;
+            }
+            size_t end = pos;
+            while (end < text.size() && (std::isxdigit(static_cast<unsigned char>(text[end])) || text[end] == '_')) {
+                ++end;
+            }
+            if (end == pos) {
+                std::cerr << "ERROR: Unexpected character '" << c << "' in memory image: " << file_name << std::endl;
+                return false;
+            }
+            std::string token = text.substr(pos, end - pos);
+            token.erase(std::remove(token.begin(), token.end(), '_'), token.end());
+            uint64_t value = std::stoull(token, nullptr, 16);
+            if (is_address) {
+                word_adr = value;
+            } else {
+                write_word(word_adr++, value);
+            }
+            pos = end;
+        }
+    }
+    return true;
+}
+
+// Функции, импортируемые ram.sv через DPI-C
+extern "C" {
+
+void* sparse_mem_create(int word_bytes) {
+    return new SparseMemory(static_cast<unsigned>(word_bytes));
+}
+
+void sparse_mem_destroy(void* mem_h) {
+    delete static_cast<SparseMemory*>(mem_h);
+}
+
+int sparse_mem_load_hex(void* mem_h, const char* file_name) {
+    return mem_h && static_cast<SparseMemory*>(mem_h)->load_hex(file_name) ? 1 : 0;
+}
+
+void sparse_mem_write(void* mem_h, unsigned long long word_adr, unsigned long long data) {
+    if (mem_h) {
+        static_cast<SparseMemory*>(mem_h)->write_word(word_adr, data);
+    }
+}
+
+unsigned long long sparse_mem_read(void* mem_h, unsigned long long word_adr, int /*write_gen*/) {
+    return mem_h ? static_cast<SparseMemory*>(mem_h)->read_word(word_adr) : 0;
+}
+
+} // extern "C"
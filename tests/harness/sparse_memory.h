@@ -0,0 +1,41 @@
+#ifndef SPARSE_MEMORY_H
+#define SPARSE_MEMORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// Постраничное хранилище слов для ram #(.SPARSE(1)). Страница выделяется при первой
+// ненулевой записи, невыделенные страницы читаются как нули -- так резидентная память
+// пропорциональна реально затронутым адресам, а не 2**RAM_REAL_SIZE.
+class SparseMemory {
+public:
+    static const unsigned PAGE_WORDS_LOG2 = 9; // 512 слов на страницу (4 KiB для 64-битных слов)
+    static const uint64_t PAGE_WORDS = 1ULL << PAGE_WORDS_LOG2;
+
+    explicit SparseMemory(unsigned word_bytes);
+
+    unsigned word_bytes() const { return word_bytes_; }
+
+    uint64_t read_word(uint64_t word_adr) const;
+    void write_word(uint64_t word_adr, uint64_t value);
+
+    // Формат $readmemh: шестнадцатеричные слова, @<адрес слова>, комментарии // и /* */.
+    bool load_hex(const std::string& file_name);
+
+    size_t resident_pages() const { return pages_.size(); }
+
+private:
+    uint64_t* find_page(uint64_t page_index) const;
+
+    unsigned word_bytes_;
+    uint64_t word_mask_;
+    std::unordered_map<uint64_t, std::unique_ptr<uint64_t[]>> pages_;
+    // Последняя использованная страница: подряд идущие обращения почти всегда в неё
+    mutable uint64_t last_page_index_ = ~0ULL;
+    mutable uint64_t* last_page_ = nullptr;
+};
+
+#endif // SPARSE_MEMORY_H
@@ -0,0 +1,93 @@
+#include "stage_bundles.h"
+
+#include <algorithm>
+
+namespace {
+
+// Последовательное чтение полей упакованной структуры от младшего бита: Verilator
+// хранит порты шире 64 бит как массив 32-битных слов (VlWide), младшее слово первое.
+class BitReader {
+public:
+    explicit BitReader(const EData* words) : words_(words) {}
+
+    uint64_t take(unsigned width) {
+        uint64_t value = 0;
+        for (unsigned done = 0; done < width;) {
+            unsigned shift = bit_ % 32;
+            unsigned chunk = std::min(32 - shift, width - done);
+            uint64_t bits = (words_[bit_ / 32] >> shift) & ((1ULL << chunk) - 1);
+            value |= bits << done;
+            done += chunk;
+            bit_ += chunk;
+        }
+        return value;
+    }
+
+private:
+    const EData* words_;
+    unsigned bit_ = 0;
+};
+
+} // namespace
+
+// Порядок take() -- поля структуры снизу вверх (последнее поле занимает младшие биты)
+void read_stage_bundles(const Vpipeline& top, StageBundles& stages) {
+    BitReader if_id(top.if_id_o.data());
+    stages.if_id.fused = if_id.take(1);
+    stages.if_id.pred_taken = if_id.take(1);
+    stages.if_id.instr2 = static_cast<uint32_t>(if_id.take(32));
+    stages.if_id.instr = static_cast<uint32_t>(if_id.take(32));
+    stages.if_id.pred_target = if_id.take(64);
+    stages.if_id.pc_4 = if_id.take(64);
+    stages.if_id.pc = if_id.take(64);
+
+    BitReader id_ex(top.id_ex_o.data());
+    IdExBundle& e = stages.id_ex;
+    e.fused = id_ex.take(1);
+    e.pred_taken = id_ex.take(1);
+    e.pc_rel = id_ex.take(1);
+    e.jalr = id_ex.take(1);
+    e.halt = id_ex.take(1);
+    e.alu_src = id_ex.take(1);
+    e.branch = id_ex.take(1);
+    e.jump = id_ex.take(1);
+    e.muldiv = id_ex.take(1);
+    e.mem_write = id_ex.take(1);
+    e.reg_write = id_ex.take(1);
+    e.result_src = static_cast<uint8_t>(id_ex.take(2));
+    e.muldiv_op = static_cast<uint8_t>(id_ex.take(4));
+    e.funct3 = static_cast<uint8_t>(id_ex.take(3));
+    e.alu_control = static_cast<uint8_t>(id_ex.take(4));
+    e.rd = static_cast<uint8_t>(id_ex.take(5));
+    e.rs2 = static_cast<uint8_t>(id_ex.take(5));
+    e.rs1 = static_cast<uint8_t>(id_ex.take(5));
+    e.pred_target = id_ex.take(64);
+    e.rd2 = id_ex.take(64);
+    e.rd1 = id_ex.take(64);
+    e.imm = id_ex.take(64);
+    e.pc_4 = id_ex.take(64);
+    e.pc = id_ex.take(64);
+
+    BitReader ex_mem(top.ex_mem_o.data());
+    ExMemBundle& m = stages.ex_mem;
+    m.fused = ex_mem.take(1);
+    m.halt = ex_mem.take(1);
+    m.mem_write = ex_mem.take(1);
+    m.reg_write = ex_mem.take(1);
+    m.result_src = static_cast<uint8_t>(ex_mem.take(2));
+    m.rd = static_cast<uint8_t>(ex_mem.take(5));
+    m.write_data = ex_mem.take(64);
+    m.alu_result = ex_mem.take(64);
+    m.pc_4 = ex_mem.take(64);
+
+    BitReader mem_wb(top.mem_wb_o.data());
+    MemWbBundle& w = stages.mem_wb;
+    w.fused = mem_wb.take(1);
+    w.halt = mem_wb.take(1);
+    w.reg_write = mem_wb.take(1);
+    w.result_src = static_cast<uint8_t>(mem_wb.take(2));
+    w.rd = static_cast<uint8_t>(mem_wb.take(5));
+    w.read_data = mem_wb.take(64);
+    w.alu_result = mem_wb.take(64);
+    w.pc_4 = mem_wb.take(64);
+}
@@ -0,0 +1,83 @@
+#ifndef STAGE_BUNDLES_H
+#define STAGE_BUNDLES_H
+
+#include "Vpipeline.h"
+
+#include <cstdint>
+
+// Содержимое межстадийных регистров Vpipeline за один такт: порты if_id_o, id_ex_o,
+// ex_mem_o и mem_wb_o (упакованные структуры из rtl/common/pipeline_stages.svh).
+// Поля и их порядок совпадают с RTL. Пузырь или сброшенный слот виден как pc_4 == 0.
+// Слитая пара (fused) занимает один слот, её первая команда по адресу pc_4 - 8.
+
+struct IfIdBundle {        // стадия Decode
+    uint64_t pc = 0;
+    uint64_t pc_4 = 0;
+    uint64_t pred_target = 0;  // предсказание Fetch (BRANCH_PREDICTOR)
+    uint32_t instr = 0;
+    uint32_t instr2 = 0;       // MACRO_FUSION: вторая команда слитой пары
+    bool pred_taken = false;
+    bool fused = false;        // слитая пара: pc_4 == pc + 8
+};
+
+struct IdExBundle {        // стадия Execute
+    uint64_t pc = 0;
+    uint64_t pc_4 = 0;
+    uint64_t imm = 0;
+    uint64_t rd1 = 0;
+    uint64_t rd2 = 0;
+    uint64_t pred_target = 0;
+    uint8_t rs1 = 0;
+    uint8_t rs2 = 0;
+    uint8_t rd = 0;
+    uint8_t alu_control = 0;
+    uint8_t funct3 = 0;        // условие перехода для branch_unit
+    uint8_t muldiv_op = 0;     // {W, funct3} для muldiv
+    uint8_t result_src = 0;
+    bool reg_write = false;
+    bool mem_write = false;
+    bool muldiv = false;       // M-расширение: умножитель или делитель
+    bool jump = false;
+    bool branch = false;
+    bool alu_src = false;
+    bool halt = false;
+    bool jalr = false;
+    bool pc_rel = false;       // AUIPC: результат pc + imm
+    bool pred_taken = false;
+    bool fused = false;
+};
+
+struct ExMemBundle {       // стадия Memory
+    uint64_t pc_4 = 0;
+    uint64_t alu_result = 0;
+    uint64_t write_data = 0;
+    uint8_t rd = 0;
+    uint8_t result_src = 0;
+    bool reg_write = false;
+    bool mem_write = false;
+    bool halt = false;
+    bool fused = false;
+};
+
+struct MemWbBundle {       // стадия Writeback
+    uint64_t pc_4 = 0;
+    uint64_t alu_result = 0;
+    uint64_t read_data = 0;
+    uint8_t rd = 0;
+    uint8_t result_src = 0;
+    bool reg_write = false;
+    bool halt = false;
+    bool fused = false;
+};
+
+struct StageBundles {
+    IfIdBundle if_id;
+    IdExBundle id_ex;
+    ExMemBundle ex_mem;
+    MemWbBundle mem_wb;
+};
+
+// Читает все четыре регистра после eval() по фронту.
+void read_stage_bundles(const Vpipeline& top, StageBundles& stages);
+
+#endif // STAGE_BUNDLES_H
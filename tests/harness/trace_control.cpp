@@ -0,0 +1,181 @@
+#include "trace_control.h"
+
+#include "stage_bundles.h"
+
+#include <fstream>
+#include <iostream>
+
+TraceControl::TraceControl(Vpipeline* top, const TraceOptions& opts) : top_(top), opts_(opts) {
+    if (opts_.history_cycles > 0) {
+        history_.resize(opts_.history_cycles);
+    }
+}
+
+TraceControl::~TraceControl() {
+    close();
+}
+
+bool TraceControl::open(const std::string& default_base_name) {
+    std::string file_name = opts_.file_name;
+    switch (opts_.format) {
+    case TraceFormat::Off:
+        return true;
+    case TraceFormat::Vcd:
+#if VM_TRACE_VCD
+        if (file_name.empty()) file_name = default_base_name + ".vcd";
+        top_->contextp()->traceEverOn(true);
+        vcd_ = new VerilatedVcdC;
+        top_->trace(vcd_, 99);
+        vcd_->open(file_name.c_str());
+        opened_ = vcd_->isOpen();
+        break;
+#else
+        std::cerr << "ERROR: Model was built without VCD tracing (PIPELINE_TRACE=VCD)." << std::endl;
+        return false;
+#endif
+    case TraceFormat::Fst:
+#if VM_TRACE_FST
+        if (file_name.empty()) file_name = default_base_name + ".fst";
+        top_->contextp()->traceEverOn(true);
+        fst_ = new VerilatedFstC;
+        top_->trace(fst_, 99);
+        fst_->open(file_name.c_str());
+        opened_ = fst_->isOpen();
+        break;
+#else
+        std::cerr << "ERROR: Model was built without FST tracing (PIPELINE_TRACE=FST)." << std::endl;
+        return false;
+#endif
+    }
+    if (!opened_) {
+        std::cerr << "ERROR: Could not open trace file: " << file_name << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void TraceControl::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+#if VM_TRACE_VCD
+    if (vcd_) {
+        vcd_->close();
+        delete vcd_;
+        vcd_ = nullptr;
+    }
+#endif
+#if VM_TRACE_FST
+    if (fst_) {
+        fst_->close();
+        delete fst_;
+        fst_ = nullptr;
+    }
+#endif
+}
+
+void TraceControl::dump(uint64_t cycle, uint64_t time) {
+    if (!opened_ || closed_ || cycle < opts_.start_cycle) {
+        return;
+    }
+    if (cycle >= opts_.stop_cycle) {
+        close(); // окно закончилось: дописываем буфер и больше не платим за трассировку
+        return;
+    }
+#if VM_TRACE_VCD
+    if (vcd_) vcd_->dump(time);
+#endif
+#if VM_TRACE_FST
+    if (fst_) fst_->dump(time);
+#endif
+}
+
+void TraceControl::sample_ports(uint64_t cycle) {
+    if (history_.empty()) {
+        return;
+    }
+    PortSample& sample = history_[history_next_];
+    sample.cycle = cycle;
+    sample.pc_f = top_->pc_f_o;
+    sample.instr_f = top_->instr_f_o;
+    sample.imm = top_->imm_o;
+    sample.rd = top_->rd_o;
+    sample.rs1 = top_->rs1_o;
+    sample.rs1_val = top_->rs1_val_o;
+    sample.rs2 = top_->rs2_o;
+    sample.rs2_val = top_->rs2_val_o;
+    sample.wd3 = top_->wd3_d_o;
+    sample.we3 = top_->we3_d_o;
+    StageBundles stages;
+    read_stage_bundles(*top_, stages);
+    sample.pc_d = stages.if_id.pc;
+    sample.pc_e = stages.id_ex.pc;
+    sample.pc_m = stages.ex_mem.pc_4 - (stages.ex_mem.fused ? 8 : 4);
+    sample.pc_w = stages.mem_wb.pc_4 - (stages.mem_wb.fused ? 8 : 4);
+
+    history_next_ = (history_next_ + 1) % history_.size();
+    if (history_count_ < history_.size()) {
+        history_count_++;
+    }
+}
+
+static void write_vcd_value(std::ofstream& out, uint64_t value, int width, const char* id) {
+    if (width == 1) {
+        out << (value & 1) << id << "\n";
+        return;
+    }
+    out << 'b';
+    for (int bit = width - 1; bit >= 0; --bit) {
+        out << ((value >> bit) & 1);
+    }
+    out << ' ' << id << "\n";
+}
+
+bool TraceControl::write_history(const std::string& file_name) const {
+    if (history_count_ == 0) {
+        return true;
+    }
+    std::ofstream out(file_name, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open history file: " << file_name << std::endl;
+        return false;
+    }
+
+    struct Var { const char* id; const char* name; int width; };
+    static const Var vars[] = {
+        {"!", "pc_f_o", 64}, {"\"", "instr_f_o", 32}, {"#", "imm_o", 64},
+        {"$", "rd_o", 5}, {"%", "rs1_o", 5}, {"&", "rs1_val_o", 64},
+        {"'", "rs2_o", 5}, {"(", "rs2_val_o", 64}, {")", "wd3_d_o", 64},
+        {"*", "we3_d_o", 1}, {"+", "pc_d", 64}, {",", "pc_e", 64},
+        {"-", "pc_m", 64}, {".", "pc_w", 64},
+    };
+
+    out << "$timescale 1ns $end\n$scope module pipeline $end\n";
+    for (const Var& var : vars) {
+        out << "$var wire " << var.width << ' ' << var.id << ' ' << var.name << " $end\n";
+    }
+    out << "$upscope $end\n$enddefinitions $end\n";
+
+    size_t first = (history_next_ + history_.size() - history_count_) % history_.size();
+    for (size_t i = 0; i < history_count_; ++i) {
+        const PortSample& s = history_[(first + i) % history_.size()];
+        out << '#' << s.cycle << "\n";
+        write_vcd_value(out, s.pc_f, 64, vars[0].id);
+        write_vcd_value(out, s.instr_f, 32, vars[1].id);
+        write_vcd_value(out, s.imm, 64, vars[2].id);
+        write_vcd_value(out, s.rd, 5, vars[3].id);
+        write_vcd_value(out, s.rs1, 5, vars[4].id);
+        write_vcd_value(out, s.rs1_val, 64, vars[5].id);
+        write_vcd_value(out, s.rs2, 5, vars[6].id);
+        write_vcd_value(out, s.rs2_val, 64, vars[7].id);
+        write_vcd_value(out, s.wd3, 64, vars[8].id);
+        write_vcd_value(out, s.we3, 1, vars[9].id);
+        write_vcd_value(out, s.pc_d, 64, vars[10].id);
+        write_vcd_value(out, s.pc_e, 64, vars[11].id);
+        write_vcd_value(out, s.pc_m, 64, vars[12].id);
+        write_vcd_value(out, s.pc_w, 64, vars[13].id);
+    }
+    std::cout << "Wrote last " << history_count_ << " cycles of port history to " << file_name << std::endl;
+    return true;
+}
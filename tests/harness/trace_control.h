@@ -0,0 +1,86 @@
+#ifndef TRACE_CONTROL_H
+#define TRACE_CONTROL_H
+
+#include "Vpipeline.h"
+#include "verilated.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "sim_options.h"
+
+#ifndef VM_TRACE
+#define VM_TRACE 0
+#endif
+#ifndef VM_TRACE_FST
+#define VM_TRACE_FST 0
+#endif
+#ifndef VM_TRACE_VCD
+#define VM_TRACE_VCD (VM_TRACE && !VM_TRACE_FST)
+#endif
+
+#if VM_TRACE_VCD
+#include "verilated_vcd_c.h"
+#endif
+#if VM_TRACE_FST
+#include "verilated_fst_c.h"
+#endif
+
+// Оконная трассировка всех сигналов модели и кольцевой буфер значений на портах.
+class TraceControl {
+public:
+    TraceControl(Vpipeline* top, const TraceOptions& opts);
+    ~TraceControl();
+
+    TraceControl(const TraceControl&) = delete;
+    TraceControl& operator=(const TraceControl&) = delete;
+
+    bool open(const std::string& default_base_name);
+    void close();
+
+    // После каждого eval(): пишет дамп, если cycle попадает в окно.
+    void dump(uint64_t cycle, uint64_t time);
+
+    // После полного такта: запоминает порты в кольцевом буфере.
+    void sample_ports(uint64_t cycle);
+
+    // Записывает содержимое кольцевого буфера в VCD (вызывается при ошибке).
+    bool write_history(const std::string& file_name) const;
+
+private:
+    struct PortSample {
+        uint64_t cycle;
+        uint64_t pc_f;
+        uint32_t instr_f;
+        uint64_t imm;
+        uint8_t rd;
+        uint8_t rs1;
+        uint64_t rs1_val;
+        uint8_t rs2;
+        uint64_t rs2_val;
+        uint64_t wd3;
+        bool we3;
+        uint64_t pc_d;     // PC инструкций в Decode..Writeback (из stage_bundles.h)
+        uint64_t pc_e;
+        uint64_t pc_m;
+        uint64_t pc_w;
+    };
+
+    Vpipeline* top_;
+    TraceOptions opts_;
+    bool opened_ = false;
+    bool closed_ = false;
+#if VM_TRACE_VCD
+    VerilatedVcdC* vcd_ = nullptr;
+#endif
+#if VM_TRACE_FST
+    VerilatedFstC* fst_ = nullptr;
+#endif
+
+    std::vector<PortSample> history_;
+    size_t history_next_ = 0;
+    size_t history_count_ = 0;
+};
+
+#endif // TRACE_CONTROL_H
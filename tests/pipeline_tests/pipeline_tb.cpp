@@ -1,6 +1,5 @@
-#include "Vpipeline.h"
-#include "verilated_vcd_c.h"
-#include "verilated.h"
+#include "pipeline_harness.h"
+#include "sim_options.h"
 
 #include <iostream>
 #include <fstream>
@@ -10,48 +9,8 @@
 #include <sstream>
 #include <cassert>
 
-// Макросы, определяемые CMake
-#ifndef PIPELINE_TEST_CASE_NAME_STR_RAW
-#error "PIPELINE_TEST_CASE_NAME_STR_RAW not defined! Pass it via CFLAGS from CMake."
-#endif
-
-#ifndef EXPECTED_WD3_FILE_PATH_STR_RAW
-#error "EXPECTED_WD3_FILE_PATH_STR_RAW not defined! Pass it via CFLAGS from CMake."
-#endif
-
-#ifndef NUM_CYCLES_TO_RUN
-#error "NUM_CYCLES_TO_RUN not defined! Pass it via CFLAGS from CMake."
-#endif
-
-// Вспомогательные макросы для превращения в строку
-#define STRINGIFY_HELPER(x) #x
-#define STRINGIFY(x) STRINGIFY_HELPER(x)
-
-// Глобальные переменные из макросов
-const std::string G_PIPELINE_TEST_CASE_NAME = STRINGIFY(PIPELINE_TEST_CASE_NAME_STR_RAW);
-const std::string G_EXPECTED_WD3_FILE_PATH = STRINGIFY(EXPECTED_WD3_FILE_PATH_STR_RAW);
-const int G_NUM_CYCLES_TO_RUN = NUM_CYCLES_TO_RUN;
 const uint64_t X_DEF = 0xFFFFFFFFFFFFFFFFUL;
 
-
-vluint64_t sim_time = 0;
-
-double sc_time_stamp() {
-    return sim_time;
-}
-
-void tick(Vpipeline* top, VerilatedVcdC* tfp) {
-    top->clk_i = 0;
-    top->eval();
-    if (tfp) tfp->dump(sim_time);
-    sim_time++;
-
-    top->clk_i = 1;
-    top->eval();
-    if (tfp) tfp->dump(sim_time);
-    sim_time++;
-}
-
 bool load_expected_wd3_values(const std::string& filepath, std::vector<uint64_t>& values, int expected_num_cycles) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
@@ -80,43 +39,53 @@ bool load_expected_wd3_values(const std::string& filepath, std::vector<uint64_t>
     file.close();
     if (line_count < expected_num_cycles) {
         std::cerr << "ERROR: Number of expected wd3_o values (" << line_count
-                  << ") is less than NUM_CYCLES_TO_RUN (" << expected_num_cycles << ")." << std::endl;
+                  << ") is less than the number of cycles to run (" << expected_num_cycles << ")." << std::endl;
         std::cerr << "Please provide an expected value (or 'X' if no write) for each cycle." << std::endl;
         return false;
     }
     if (line_count > expected_num_cycles) {
          std::cerr << "Warning: Number of expected wd3_o values (" << line_count
-                  << ") is greater than NUM_CYCLES_TO_RUN (" << expected_num_cycles << ")." << std::endl;
+                  << ") is greater than the number of cycles to run (" << expected_num_cycles << ")." << std::endl;
     }
     return true;
 }
 
 int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
-    Vpipeline* top = new Vpipeline;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    std::string vcd_file_name = G_PIPELINE_TEST_CASE_NAME + "_pipeline_tb.vcd";
-    tfp->open(vcd_file_name.c_str());
+    SimOptions opts;
+    if (!parse_sim_options(argc, argv, opts) || opts.expected_file.empty()) {
+        print_sim_options_usage(argv[0]);
+        return 1;
+    }
+    const int num_cycles_to_run = static_cast<int>(opts.num_cycles);
 
-    std::cout << "Starting Pipeline Test Case: " << G_PIPELINE_TEST_CASE_NAME << std::endl;
-    std::cout << "Expected wd3_o file: " << G_EXPECTED_WD3_FILE_PATH << std::endl;
-    std::cout << "Number of cycles to run: " << G_NUM_CYCLES_TO_RUN << std::endl;
+    std::cout << "Starting Pipeline Test Case: " << opts.test_name << std::endl;
+    std::cout << "Program: " << (opts.elf_file.empty() ? opts.instr_mem_file : opts.elf_file) << std::endl;
+    std::cout << "Expected wd3_o file: " << opts.expected_file << std::endl;
+    std::cout << "Number of cycles to run: " << num_cycles_to_run << std::endl;
 
     std::vector<uint64_t> expected_wd3_per_cycle;
-    if (!load_expected_wd3_values(G_EXPECTED_WD3_FILE_PATH, expected_wd3_per_cycle, G_NUM_CYCLES_TO_RUN)) {
-        if (tfp) tfp->close();
-        delete top;
+    if (!load_expected_wd3_values(opts.expected_file, expected_wd3_per_cycle, num_cycles_to_run)) {
+        return 1;
+    }
+
+    // Потактовая таблица ожиданий отсчитывается от сброса
+    if (!opts.checkpoint.restore_file.empty()) {
+        std::cerr << "ERROR: --checkpoint-restore is not supported by this testbench." << std::endl;
         return 1;
     }
 
-    top->rst_i = 1;
-    for(int i=0; i<2; ++i) {
-        tick(top, tfp);
+    PipelineHarness harness(opts);
+    Vpipeline* top = harness.top();
+    if (!harness.load_program()) {
+        return 1;
     }
-    top->rst_i = 0;
+    if (!harness.open_trace(opts.test_name + "_pipeline_tb")) {
+        return 1;
+    }
+
+    harness.reset();
     std::cout << "Reset complete." << std::endl;
 
     bool test_passed = true;
@@ -124,8 +93,8 @@ int main(int argc, char** argv) {
     std::cout << "\nCycle | PC_F     | Instr_D  | WE3 | WD3_Out (Got) | WD3_Out (Exp) | Status" << std::endl;
     std::cout << "------|----------|----------|-----|---------------|-----------------|-------" << std::endl;
 
-    for (int cycle = 0; cycle < G_NUM_CYCLES_TO_RUN; ++cycle) {
-        tick(top, tfp);
+    for (int cycle = 0; cycle < num_cycles_to_run; ++cycle) {
+        harness.tick();
 
         uint64_t current_wd3_value = top->wd3_d_o;
         bool current_we3 = top->we3_d_o;
@@ -170,16 +139,15 @@ int main(int argc, char** argv) {
         std::cout << std::setfill(' ');
     }
 
-    if (tfp) {
-        tfp->close();
+    if (!test_passed) {
+        harness.report_failure();
     }
-    delete top;
 
     if (test_passed) {
-        std::cout << "\nPipeline Test Case: " << G_PIPELINE_TEST_CASE_NAME << " - PASSED" << std::endl;
+        std::cout << "\nPipeline Test Case: " << opts.test_name << " - PASSED" << std::endl;
         return 0;
     } else {
-        std::cout << "\nPipeline Test Case: " << G_PIPELINE_TEST_CASE_NAME << " - FAILED" << std::endl;
+        std::cout << "\nPipeline Test Case: " << opts.test_name << " - FAILED" << std::endl;
         return 1;
     }
 }
\ No newline at end of file
@@ -49,10 +49,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Valu* top = new Valu;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_alu.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_alu.vcd");
+    }
 
     std::cout << "Starting Simplified ALU Testbench (RV64)" << std::endl;
 
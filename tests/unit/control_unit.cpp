@@ -20,6 +20,7 @@ const uint8_t OPCODE_LOAD    = 0b0000011;
 const uint8_t OPCODE_STORE   = 0b0100011;
 const uint8_t OPCODE_I_ALU   = 0b0010011;
 const uint8_t OPCODE_R_ALU   = 0b0110011;
+const uint8_t OPCODE_R_ALU_W = 0b0111011;
 
 // ImmSel (matches opcodes.svh)
 const uint8_t IMM_SEL_I = 0b00;
@@ -31,6 +32,7 @@ const uint8_t IMM_SEL_J = 0b11;
 const uint8_t RESSRC_ALU = 0b00;
 const uint8_t RESSRC_MEM = 0b01;
 const uint8_t RESSRC_PC4 = 0b10;
+const uint8_t RESSRC_MUL = 0b11;
 
 // ALU Operations (matches alu_defines.svh)
 const uint8_t ALU_OP_ADD      = 0b000;
@@ -80,14 +82,31 @@ struct CU_TestCase {
     bool    expected_ALUModifierD;
 };
 
+// M-расширение: funct7 = 0000001 (instr[25]) в OP и OP-32
+struct MulDiv_TestCase {
+    std::string name;
+    uint8_t op_i;
+    uint8_t funct3_i;
+    uint8_t funct7_0_i;
+
+    bool    expected_MulDivD;
+    uint8_t expected_MulDivOpD;  // {W, funct3}
+    bool    expected_RegWriteD;
+    uint8_t expected_ResultSrcD;
+};
+
 int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vcontrol_unit* top = new Vcontrol_unit;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_control_unit.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_control_unit.vcd");
+    }
 
     std::cout << "Starting Control Unit Testbench" << std::endl;
 
@@ -166,12 +185,46 @@ int main(int argc, char** argv) {
         }
     }
 
+    std::vector<MulDiv_TestCase> muldiv_cases = {
+        // name, op, f3, f7_0 | MulDiv, MulDivOp, RegW, ResSrc
+        {"MUL",    OPCODE_R_ALU,   0b000,1, true, 0b0000,true, RESSRC_MUL},
+        {"MULHU",  OPCODE_R_ALU,   0b011,1, true, 0b0011,true, RESSRC_MUL},
+        {"DIV",    OPCODE_R_ALU,   0b100,1, true, 0b0100,true, RESSRC_ALU},
+        {"REMU",   OPCODE_R_ALU,   0b111,1, true, 0b0111,true, RESSRC_ALU},
+        {"MULW",   OPCODE_R_ALU_W, 0b000,1, true, 0b1000,true, RESSRC_MUL},
+        {"DIVUW",  OPCODE_R_ALU_W, 0b101,1, true, 0b1101,true, RESSRC_ALU},
+        {"ADDW",   OPCODE_R_ALU_W, 0b000,0, false,0b1000,false,RESSRC_ALU}, // OP-32 без M не реализован
+        {"SRAI63", OPCODE_I_ALU,   0b101,1, false,0b0101,true, RESSRC_ALU}, // instr[25] -- бит shamt
+    };
+
+    int muldiv_passed = 0;
+    for (const auto& tc : muldiv_cases) {
+        top->op_i = tc.op_i;
+        top->funct3_i = tc.funct3_i;
+        top->funct7_5_i = 0;
+        top->funct7_0_i = tc.funct7_0_i;
+        eval_cu(top, tfp);
+
+        if (top->MulDivD_o == tc.expected_MulDivD && top->MulDivOpD_o == tc.expected_MulDivOpD &&
+            top->RegWriteD_o == tc.expected_RegWriteD && top->ResultSrcD_o == tc.expected_ResultSrcD) {
+            muldiv_passed++;
+            std::cout << "PASS: " << tc.name << std::endl;
+        } else {
+            std::cout << "FAIL: " << tc.name << " MulDivD " << (int)top->MulDivD_o << " | " << tc.expected_MulDivD
+                      << ", MulDivOpD " << (int)top->MulDivOpD_o << " | " << (int)tc.expected_MulDivOpD
+                      << ", RegWriteD " << (int)top->RegWriteD_o << " | " << tc.expected_RegWriteD
+                      << ", ResultSrcD " << (int)top->ResultSrcD_o << " | " << (int)tc.expected_ResultSrcD << std::endl;
+            assert(false);
+        }
+    }
+    passed_count += muldiv_passed;
+
     std::cout << "\nControl Unit Testbench Finished. Passed "
-              << passed_count << "/" << test_cases.size() << " tests." << std::endl;
+              << passed_count << "/" << test_cases.size() + muldiv_cases.size() << " tests." << std::endl;
 
     if (tfp) {
         tfp->close();
     }
     delete top;
-    return (passed_count == test_cases.size()) ? EXIT_SUCCESS : EXIT_FAILURE;
+    return (passed_count == test_cases.size() + muldiv_cases.size()) ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -32,10 +32,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vflopenr* top = new Vflopenr;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_flopenr.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_flopenr.vcd");
+    }
 
     std::cout << "Starting FLOPENR (Register with Reset and Enable) Testbench" << std::endl;
 
@@ -32,10 +32,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vflopr* top = new Vflopr;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_flopr.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_flopr.vcd");
+    }
 
     std::cout << "Starting FLOPR (Register with Reset) Testbench" << std::endl;
 
@@ -38,10 +38,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vimm* top = new Vimm;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_imm.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_imm.vcd");
+    }
 
     std::cout << "Starting Immediate Generation Testbench" << std::endl;
 
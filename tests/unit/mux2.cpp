@@ -24,10 +24,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vmux2* top = new Vmux2;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_mux2.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_mux2.vcd");
+    }
 
     std::cout << "Starting MUX2 Testbench (Width: " << DATA_WIDTH_TEST << ")" << std::endl;
 
@@ -40,10 +40,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vram* top = new Vram; // Используем Vram
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_ram.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_ram.vcd");
+    }
 
     std::cout << "Starting RAM Testbench" << std::endl;
 
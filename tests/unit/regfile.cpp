@@ -29,10 +29,14 @@ int main(int argc, char** argv) {
     Verilated::commandArgs(argc, argv);
     Vregfile* top = new Vregfile;
 
-    Verilated::traceEverOn(true);
-    VerilatedVcdC* tfp = new VerilatedVcdC;
-    top->trace(tfp, 99);
-    tfp->open("tb_regfile.vcd");
+    // VCD пишется только по +trace: без него прогон не тратит время на дамп
+    VerilatedVcdC* tfp = nullptr;
+    if (Verilated::commandArgsPlusMatch("trace")[0]) {
+        Verilated::traceEverOn(true);
+        tfp = new VerilatedVcdC;
+        top->trace(tfp, 99);
+        tfp->open("tb_regfile.vcd");
+    }
 
 
     std::cout << "Starting 64-bit Regfile Testbench" << std::endl; // Изменено сообщение
@@ -109,6 +113,24 @@ int main(int argc, char** argv) {
     std::cout << "  Read x3 (attempted write with we3=0): 0x" << std::hex << top->rd1 << std::dec << std::endl;
     assert(top->rd1 == 0 && "Read x3 after write attempt with we3=0 failed (should be 0 from initial)");
 
+    // Порты второго слота выдачи (DUAL_ISSUE): чтение a4/a5, запись a6
+    std::cout << "Cycle 7: Write x4 through we6 and read it on all ports" << std::endl;
+    top->a6 = 4; top->wd6 = val2; top->we6 = 1;
+    tick(top, tfp);
+    top->we6 = 0;
+    top->a1 = 4; top->a4 = 4; top->a5 = 1; top->eval();
+    assert(top->rd1 == val2 && "Read x4 through rd1 after we6 write failed");
+    assert(top->rd4 == val2 && "Read x4 through rd4 failed");
+    assert(top->rd5 == val1 && "Read x1 through rd5 failed");
+
+    std::cout << "Cycle 8: Both write ports target x6, port 6 (younger) wins" << std::endl;
+    top->a3 = 6; top->wd3 = val1; top->we3 = 1;
+    top->a6 = 6; top->wd6 = val3; top->we6 = 1;
+    tick(top, tfp);
+    top->we3 = 0; top->we6 = 0;
+    top->a2 = 6; top->a5 = 6; top->eval();
+    assert(top->rd2 == val3 && top->rd5 == val3 && "Port 6 should win a same-register write");
+
 
     std::cout << "64-bit Regfile Testbench Finished Successfully!" << std::endl;
 